@@ -90,14 +90,37 @@ TypeLONG = "Integer64";
 TypeULNG = "UnsignedInteger64";
 TypeTEXT = "TerminatedString";
 TypeBOOL = "Character8";
+TypeFLT32 = "Real32";
+TypeINT8 = "Integer8";
+TypeINT16 = "Integer16";
+TypeINT64 = "Integer64";
+TypeUINT8 = "UnsignedInteger8";
+TypeUINT16 = "UnsignedInteger16";
+TypeUINT32 = "UnsignedInteger32";
+TypeUINT64 = "UnsignedInteger64";
 
 (* data type headers *)
 CMMREAL = "R";
 CMMINTG = "I";
 CMMLONG = "L"; 
 CMMULNG = "U";
+CMMFLT32 = "F";   (* fixed width numbers *)
+CMMINT8 = "c";
+CMMINT16 = "s";
+CMMINT64 = "l";
+CMMUINT8 = "o";
+CMMUINT16 = "w";
+CMMUINT32 = "u";
+CMMUINT64 = "q";
 CMMTEXT = "T";
+CMMPTXT = "P";
+CMMDTXT = "D";   (* dictionary coded text *)
 CMMBOOL = "B";
+CMMBITS = "b";   (* bit packed bool *)
+CMMTILE = "M";   (* tiled array *)
+CMMHALF = "H";   (* IEEE half precision real *)
+CMMBF16 = "G";   (* bfloat16 real *)
+CMMQUANT = "Q";  (* quantized real *)
 
 CMMBOOLTrue = "t";
 CMMBOOLFalse = "f";
@@ -105,6 +128,8 @@ CMMBOOLFalse = "f";
 CMMSEQS = "S";
 CMMSEQE = "E";
 
+CMMINDEXMagic = 16^^5844494D4D43; (* "CMMIDX" *)
+
 Begin["`Private`"]
 
 $CMMFilePrintInfo = False;
@@ -128,6 +153,14 @@ FromCMMType[CMMLONG] := TypeLONG;
 FromCMMType[CMMULNG] := TypeULNG;
 FromCMMType[CMMTEXT] := TypeTEXT;
 FromCMMType[CMMBOOL] := TypeBOOL;
+FromCMMType[CMMFLT32] := TypeFLT32;
+FromCMMType[CMMINT8] := TypeINT8;
+FromCMMType[CMMINT16] := TypeINT16;
+FromCMMType[CMMINT64] := TypeINT64;
+FromCMMType[CMMUINT8] := TypeUINT8;
+FromCMMType[CMMUINT16] := TypeUINT16;
+FromCMMType[CMMUINT32] := TypeUINT32;
+FromCMMType[CMMUINT64] := TypeUINT64;
 
 CMMType[data_]:=(Message[CMMFile::error, "No CMMType for data."]; "");
 
@@ -151,6 +184,14 @@ SizeOfCMMType[CMMLONG] := 8;
 SizeOfCMMType[CMMULNG] := 8;
 SizeOfCMMType[CMMTEXT] := 1;
 SizeOfCMMType[CMMBOOL] := 1;
+SizeOfCMMType[CMMFLT32] := 4;
+SizeOfCMMType[CMMINT8] := 1;
+SizeOfCMMType[CMMINT16] := 2;
+SizeOfCMMType[CMMINT64] := 8;
+SizeOfCMMType[CMMUINT8] := 1;
+SizeOfCMMType[CMMUINT16] := 2;
+SizeOfCMMType[CMMUINT32] := 4;
+SizeOfCMMType[CMMUINT64] := 8;
 
 SizeOf[TypeREAL] = 8;
 SizeOf[TypeINTG] = 4;
@@ -165,6 +206,8 @@ TypeSIZE  = "Integer32";
 
 FromCMMBool[CMMBOOLTrue] = True;
 FromCMMBool[CMMBOOLFalse]= False;
+FromCMMBool[1] = True;
+FromCMMBool[0] = False;
 ToCMMBool[True] = CMMBOOLTrue;
 ToCMMBool[False]= CMMBOOLFalse;
 
@@ -230,6 +273,106 @@ ReadCMMData[str_InputStream, CMMBOOL, s_]:=Module[{l = Length[s]},
 
 
 
+(* bit packed bools: 8 values per byte, lowest bit first, n = Infinity reads to end of file
+   where a stop bit follows the last value *)
+ReadCMMBits[str_InputStream, n_]:=Module[{dat, m = n},
+   dat = If[n === Infinity,
+      BinaryReadList[str, "UnsignedInteger8"],
+      BinaryReadList[str, "UnsignedInteger8", Ceiling[n/8]]
+   ];
+   If[n === Infinity,
+      m = 8 Length[dat];
+      If[m > 0 && Last[dat] != 0, m = 8 (Length[dat] - 1) + BitLength[Last[dat]] - 1];
+   ];
+   dat = Flatten[Reverse /@ IntegerDigits[dat, 2, 8]];
+   FromCMMBool /@ Take[dat, m]
+];
+
+ReadCMMData[str_InputStream, CMMBITS, s_]:=Module[{l = Length[s], dat},
+   If[l==0, Return[First[ReadCMMBits[str, 1]]]];
+   dat = ReadCMMBits[str, If[s[[1]] == -1, Infinity, Times @@ s]];
+
+   (* resize data *)
+   If[l==1, Return[dat]];
+   Fold[Partition, dat, Reverse[Drop[s,1]]]
+];
+
+(* length prefixed text: total length, offsets, null terminated strings *)
+ReadCMMData[str_InputStream, CMMPTXT, s_]:=Module[{l = Length[s], n, nb, pos, end, dat},
+   nb = BinaryRead[str, TypeLONG];
+   If[l > 0 && s[[1]] == -1,
+      pos = StreamPosition[str];
+      SetStreamPosition[str, Infinity];
+      end = StreamPosition[str];
+      SetStreamPosition[str, pos];
+      n = (end - pos - nb)/8;
+   ,
+      n = Times @@ s;
+   ];
+   Skip[str, Character, 8 n];
+   dat = BinaryReadList[str, TypeTEXT, n];
+
+   (* resize data *)
+   If[l==0, Return[First[dat]]];
+   If[l==1, Return[dat]];
+   Fold[Partition, dat, Reverse[Drop[s,1]]]
+];
+
+(* dictionary coded text: number of distinct strings, strings as length prefixed text, codes *)
+ReadCMMData[str_InputStream, CMMDTXT, s_]:=Module[{l = Length[s], m, dict, codes, dat},
+   m = BinaryRead[str, TypeLONG];
+   BinaryRead[str, TypeLONG];
+   Skip[str, Character, 8 m];
+   dict = BinaryReadList[str, TypeTEXT, m];
+   codes = If[s[[1]] == -1,
+      BinaryReadList[str, TypeINTG],
+      BinaryReadList[str, TypeINTG, Times @@ s]
+   ];
+   dat = dict[[codes + 1]];
+
+   (* resize data *)
+   If[l==1, Return[dat]];
+   Fold[Partition, dat, Reverse[Drop[s,1]]]
+];
+
+(* tiled array: value type, number of bytes, tile size, padded tiles in row major order *)
+ReadCMMData[str_InputStream, CMMTILE, s_]:=Module[{l = Length[s], t, tile, grid, dat},
+   t = FromCMMType[FromCharacterCode[BinaryRead[str, "UnsignedInteger8"]]];
+   BinaryRead[str, TypeLONG];
+   tile = BinaryReadList[str, TypeINTG, l];
+   grid = Ceiling[s/tile];
+   dat = ArrayReshape[BinaryReadList[str, t, (Times @@ tile) (Times @@ grid)], Join[grid, tile]];
+   dat = ArrayReshape[Transpose[dat, Join[Range[1, 2 l, 2], Range[2, 2 l, 2]]], grid tile];
+   Take[dat, Sequence @@ s]
+];
+
+(* lossy stored reals: 16 bit half / bfloat16 values, or code type, offset, scale and codes *)
+ReadCMMData[str_InputStream, t:(CMMHALF|CMMBF16|CMMQUANT), s_]:=Module[{l = Length[s], h, e, m, c, q, dat},
+   If[t == CMMQUANT,
+      c = FromCMMType[FromCharacterCode[BinaryRead[str, "UnsignedInteger8"]]];
+      q = BinaryReadList[str, TypeREAL, 2];
+      dat = q[[1]] + q[[2]] BinaryReadList[str, c, Times @@ s];
+   ,
+      h = If[l > 0 && s[[1]] == -1,
+         BinaryReadList[str, "UnsignedInteger16"],
+         BinaryReadList[str, "UnsignedInteger16", Times @@ s]
+      ];
+      dat = If[t == CMMBF16,
+         ImportString[ExportString[BitShiftLeft[h, 16], "UnsignedInteger32"], "Real32"],
+         e = BitAnd[BitShiftRight[h, 10], 31];
+         m = BitAnd[h, 1023];
+         (1 - 2 BitShiftRight[h, 15]) MapThread[
+            Which[#1 == 0, #2 2.^-24, #1 == 31, If[#2 == 0, Infinity, Indeterminate], True, (1 + #2/1024.) 2.^(#1 - 15)]&,
+            {e, m}]
+      ];
+   ];
+
+   (* resize data *)
+   If[l==0, Return[First[dat]]];
+   If[l==1, Return[dat]];
+   Fold[Partition, dat, Reverse[Drop[s,1]]]
+];
+
 ReadCMMData[str_InputStream, t_, s_, ns_]:=ReadCMMData[str, t, s, 1, ns];
 ReadCMMData[str_InputStream, t_, s_, nr_, ns_]:=Module[{(*ss = s,*) l = Length[s], p, n},
    (* read data *)
@@ -312,14 +455,33 @@ ReadCMMFile[filename_String]:=Module[{str = OpenReadCMMFile[filename], data},
    data
 ];
 
-ReadCMMFile[str_InputStream]:=Module[{data = {}, dat = ReadCMM[str]},
+ReadCMMFile[str_InputStream]:=Module[{data = {}, stop = CMMIndexOffset[str], dat},
+   dat = If[StreamPosition[str] < stop, ReadCMM[str], EndOfFile];
    While[dat =!= EndOfFile && dat =!= $Failed,
       data = Append[data, dat];
-      dat = ReadCMM[str];
+      dat = If[StreamPosition[str] < stop, ReadCMM[str], EndOfFile];
    ];
    data
 ];
 
+(* start of the index written by cmmfile.h at the end of the file, Infinity if there is none;
+   the index consists of two Integer64 entries: {offset, type, data, end, dim, sizes..} per entry and {offset, magic} *)
+CMMIndexOffset[str_InputStream]:=Module[{pos = StreamPosition[str], end, t, s, d, stop = Infinity},
+   SetStreamPosition[str, Infinity];
+   end = StreamPosition[str];
+   If[end - pos >= 25,
+      SetStreamPosition[str, end - 25];
+      t = ReadCMMType[str];
+      s = ReadCMMDim[str];
+      If[t == CMMINT64 && s == {2},
+         d = BinaryReadList[str, TypeINT64, 2];
+         If[d[[2]] == CMMINDEXMagic, stop = d[[1]]];
+      ];
+   ];
+   SetStreamPosition[str, pos];
+   stop
+];
+
 
 WriteCMMType[str_OutputStream, t_]:=BinaryWrite[str, t , TypeTYPE];
 
@@ -422,6 +584,15 @@ ReadCMMDataSequence[str_InputStream, t_, s_]:=Module[{l = Length[s], ss = s},
    Fold[Partition, dat, Reverse[Drop[ss,1]]]
 ];
 
+ReadCMMDataSequence[str_InputStream, CMMBITS, s_]:=Module[{l = Length[s], ss = s, dat},
+   If[l==0, Return[First[ReadCMMBits[str, 1]]]];
+   If[s[[1]] == -1, ss[[1]] = ReadCMMSize[str]];
+   dat = ReadCMMBits[str, Times @@ ss];
+   (* resize data *)
+   If[l==1, Return[dat]];
+   Fold[Partition, dat, Reverse[Drop[ss,1]]]
+];
+
 ReadCMMDataSequence[str_InputStream, CMMBOOL, s_]:=Module[{l = Length[s], ss = s},
    (* read data *)
    If[l==0, Return[FromCMMBool[BinaryRead[str, FromCMMType[t]]]]];
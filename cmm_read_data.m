@@ -13,21 +13,105 @@ function data = cmm_read_data(fid, t, s, nr, ns)
    if isempty(s) % scalar
       if strcmp(t, 'T')
          data = cmm_fread_str(fid);
+      elseif strcmp(t, 'P')
+         data = cmm_fread_prefixed_list(fid, 1);
+         data = data{1};
       elseif strcmp(t, 'B')
          data = cmm_fread_bool(fid);
+      elseif strcmp(t, 'b')
+         data = cmm_fread_bool_list(fid, 1, true);
       else
          data = fread(fid, 1, [c '=>' c]);
       end
       return
 
    else %array
-      if strcmp(t, 'T')
+      if strcmp(t, 'P')
+         if s(1)<0
+            data = cmm_fread_prefixed_list(fid, -1);
+            s(1) = numel(data)/prod(s(2:end));
+         else
+            data = cmm_fread_prefixed_list(fid, prod(s));
+         end
+         if (nr>=0)
+            p = prod(s(2:end));
+            k = 0:s(1)-1;
+            k = k(mod(k, nr+ns) < nr);
+            data = data(bsxfun(@plus, k'*p, 1:p)');
+            s(1) = numel(k);
+         end
+      elseif strcmp(t, 'T')
          if (nr<0)
             data = cmm_fread_str_list(fid, prod(s));
          else
             data = cmm_fread_str_list_skip(fid,s,nr,ns);
             s(1) = numel(data)/prod(s(2:end));
          end
+      elseif strcmp(t, 'D')
+         m = fread(fid, 1, 'int64=>double');
+         dict = cmm_fread_prefixed_list(fid, m);
+         if s(1)<0
+            codes = fread(fid, inf, 'int32=>double');
+            s(1) = numel(codes)/prod(s(2:end));
+         else
+            codes = fread(fid, prod(s), 'int32=>double');
+         end
+         data = dict(codes + 1);
+         if (nr>=0)
+            p = prod(s(2:end));
+            k = 0:s(1)-1;
+            k = k(mod(k, nr+ns) < nr);
+            data = data(bsxfun(@plus, k'*p, 1:p)');
+            s(1) = numel(k);
+         end
+      elseif strcmp(t, 'V')
+         data = cmm_fread_varint(fid);
+         if s(1)<0
+            s(1) = numel(data)/prod(s(2:end));
+         end
+         if (nr>=0)
+            p = prod(s(2:end));
+            k = 0:s(1)-1;
+            k = k(mod(k, nr+ns) < nr);
+            data = data(bsxfun(@plus, k'*p, 1:p)');
+            s(1) = numel(k);
+         end
+      elseif any(strcmp(t, {'H', 'G', 'Q'}))
+         data = cmm_fread_lossy(fid, t, s);
+         if s(1)<0
+            s(1) = numel(data)/prod(s(2:end));
+         end
+         if (nr>=0)
+            p = prod(s(2:end));
+            k = 0:s(1)-1;
+            k = k(mod(k, nr+ns) < nr);
+            data = data(bsxfun(@plus, k'*p, 1:p)');
+            s(1) = numel(k);
+         end
+      elseif strcmp(t, 'M')
+         data = cmm_fread_tiled(fid, s);
+         if (nr>=0)
+            p = prod(s(2:end));
+            k = 0:s(1)-1;
+            k = k(mod(k, nr+ns) < nr);
+            data = data(bsxfun(@plus, k'*p, 1:p)');
+            s(1) = numel(k);
+         end
+      elseif strcmp(t, 'b')
+         if s(1)<0
+            data = cmm_fread_bool_list(fid, -1, true);
+            s(1) = floor(numel(data)/prod(s(2:end)));
+            data = data(1:prod(s));
+         else
+            data = cmm_fread_bool_list(fid, prod(s), true);
+         end
+         if (nr>=0)
+            p = prod(s(2:end));
+            k = 0:s(1)-1;
+            k = k(mod(k, nr+ns) < nr);
+            data = data(bsxfun(@plus, k'*p, 1:p)');
+            s(1) = numel(k);
+         end
       elseif strcmp(t, 'B')
          if (nr<0)
             data = cmm_fread_bool_list(fid, prod(s));
@@ -75,6 +159,73 @@ end
 
 
 
+% delta varint coded integers, see write_data_varint in cmmfile.h
+function data = cmm_fread_varint(fid)
+   nb = fread(fid, 1, 'int64=>double');
+   b = fread(fid, nb, 'uint8=>double');
+   if isempty(b)
+      data = int64([]);
+      return
+   end
+   last = b < 128;                         % last byte of each value
+   g = cumsum([1; last(1:end-1)]);         % value of each byte
+   first = [1; find(last(1:end-1)) + 1];
+   z = accumarray(g, mod(b, 128) .* 2.^(7*((1:nb)' - first(g))));
+   d = z/2;
+   odd = mod(z, 2) == 1;
+   d(odd) = -(z(odd)+1)/2;
+   data = int64(cumsum(d));
+end
+
+
+
+% tiled arrays, see write_data_tiled in cmmfile.h, returns the values in row major order
+function data = cmm_fread_tiled(fid, s)
+   c = from_cmm_type(fread(fid, 1, 'uint8=>char'));
+   n = numel(s);
+   nb = fread(fid, 1, 'int64=>double');
+   tile = fread(fid, n, 'int32=>double')';
+   grid = ceil(s ./ tile);
+   data = fread(fid, prod(tile) * prod(grid), [c '=>' c]);
+   % index in tile and tile index interleaved for each dimension, last dimension first
+   data = reshape(data, [tile(end:-1:1) grid(end:-1:1)]);
+   data = permute(data, reshape([1:n; n+1:2*n], 1, []));
+   data = reshape(data, [tile(end:-1:1) .* grid(end:-1:1) 1]);
+   idx = arrayfun(@(k) 1:k, s(end:-1:1), 'UniformOutput', false);
+   data = data(idx{:});
+   data = data(:);
+end
+
+
+
+% lossy stored doubles, see write_data_half, write_data_bfloat16 and write_data_quantized in cmmfile.h
+function data = cmm_fread_lossy(fid, t, s)
+   if s(1)<0
+      n = inf;
+   else
+      n = prod(s);
+   end
+   if strcmp(t, 'Q')
+      c = from_cmm_type(fread(fid, 1, 'uint8=>char'));
+      q = fread(fid, 2, 'double');
+      data = q(1) + q(2) * fread(fid, n, [c '=>double']);
+   elseif strcmp(t, 'G')
+      data = double(typecast(bitshift(fread(fid, n, 'uint16=>uint32'), 16), 'single'));
+   else
+      h = fread(fid, n, 'uint16=>double');
+      sg = 1 - 2 * (h >= 32768);
+      e = mod(floor(h / 1024), 32);
+      m = mod(h, 1024);
+      data = sg .* pow2(1 + m / 1024, e - 15);
+      sub = e == 0;
+      data(sub) = sg(sub) .* m(sub) * 2^-24;
+      data(e == 31) = sg(e == 31) * inf;
+      data(e == 31 & m > 0) = NaN;
+   end
+end
+
+
+
 % specializations for strings
 
 %read null terminated string
@@ -104,6 +255,24 @@ function data = cmm_fread_str_list(fid, size)
    end
 end
 
+%read list of length prefixed strings, size<0 reads until end of file
+function data = cmm_fread_prefixed_list(fid, size)
+   nb = fread(fid, 1, 'int64=>double');
+   if (size < 0)
+      pos = ftell(fid);
+      fseek(fid, 0, 'eof');
+      size = (ftell(fid) - pos - nb)/8;
+      fseek(fid, pos, 'bof');
+   end
+   off = fread(fid, size, 'int64=>double');
+   blob = fread(fid, nb, 'uint8=>char')';
+   e = [off(2:end); nb];
+   data = cell(1, size);
+   for k=1:size
+      data{k} = blob(off(k)+1:e(k)-1);
+   end
+end
+
 %read list of null terminated string skip
 function data = cmm_fread_str_list_skip(fid, s, nr, ns)
    if (s(1) < 0)
@@ -143,8 +312,23 @@ function data = cmm_fread_bool(fid)
 end
 
 
-%read list of bools
-function data = cmm_fread_bool_list(fid, size)
+%read list of bools, packed lists store 8 bools per byte lowest bit first
+function data = cmm_fread_bool_list(fid, size, packed)
+   if nargin > 2 && packed
+      if (size < 0 || size == inf)
+         b = fread(fid, inf, 'uint8=>uint8');
+         size = 8*numel(b);
+         % drop the stop bit ending a -1 stream and the padding after it
+         if size > 0 && b(end) ~= 0
+            size = 8*(numel(b)-1) + floor(log2(double(b(end))));
+         end
+      else
+         b = fread(fid, ceil(size/8), 'uint8=>uint8');
+      end
+      data = logical(bitget(repmat(b(:)', 8, 1), repmat((1:8)', 1, numel(b))));
+      data = data(1:size);
+      return
+   end
    if (size < 0 || size == inf)
       data= [];
       k=1;
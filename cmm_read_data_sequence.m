@@ -4,13 +4,18 @@ function data = cmm_read_data_sequence(fid, hs)
    data = cell(1,l);
    k = 1;
    i = 1;
+   xs = zeros(l, 2);   % last two values of xor delta coded columns
    while (~feof(fid))
       t = hs{k,1};
       s = hs{k,2};
       if ~isempty(s) && s(1) == -1
             s(1) = cmm_read_size(fid);
       end      
-      dat = cmm_read_data(fid, t , s);
+      if strcmp(t, 'X')
+         [dat, xs(k,:)] = cmm_fread_xor(fid, xs(k,:));
+      else
+         dat = cmm_read_data(fid, t , s);
+      end
      
       if (isempty(s))
          data{k} = [data{k} dat];
@@ -24,4 +29,26 @@ function data = cmm_read_data_sequence(fid, hs)
       k = mod(k, l) +1;
       if (k==1) i=i+1; end
    end
-end
\ No newline at end of file
+end
+
+
+%read xor delta coded double, see write_data_xor in cmmfile.h
+function [data, last] = cmm_fread_xor(fid, last)
+   c = fread(fid, 1, 'uint8');
+   if isempty(c)
+      data = [];
+      return
+   end
+   lead = bitand(bitshift(c, -3), 15);
+   trail = bitand(c, 7);
+   n = 8 - lead - trail;
+   b = zeros(1, 8, 'uint8');
+   b(trail+1:trail+n) = fread(fid, n, 'uint8=>uint8');
+   if bitand(c, 128)
+      p = 2*last(1) - last(2);
+   else
+      p = last(1);
+   end
+   data = typecast(bitxor(typecast(b, 'uint64'), typecast(p, 'uint64')), 'double');
+   last = [data last(1)];
+end
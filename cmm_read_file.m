@@ -11,8 +11,9 @@ function data = cmm_read_file(f)
    data = {};
    k = 1;
    
+   stop = cmm_index_offset(fid);
    t = cmm_read_type(fid)
-   while ~feof(fid)
+   while ~feof(fid) && ftell(fid) <= stop
       fseek(fid, -1, 'cof');
       if strcmp(t, 'S')
          seq = cmm_read_sequence(fid);
@@ -33,5 +34,22 @@ function data = cmm_read_file(f)
 end
 
 
-
-      
+% start of the index written by cmmfile.h at the end of the file, inf if there is none
+% the index consists of two int64 entries: [offset type data end dim sizes..] per entry and [offset magic]
+function pos = cmm_index_offset(fid)
+   pos = inf;
+   here = ftell(fid);
+   fseek(fid, 0, 'eof');
+   if ftell(fid) - here >= 25
+      fseek(fid, -25, 'eof');
+      t = cmm_read_type(fid);
+      s = cmm_read_dim(fid);
+      if strcmp(t, 'l') && isequal(s, 2)
+         d = fread(fid, 2, 'int64=>int64');
+         if d(2) == int64(97050310823235)   % 'CMMIDX'
+            pos = double(d(1));
+         end
+      end
+   end
+   fseek(fid, here, 'bof');
+end
@@ -60,6 +60,97 @@
       cmmfile.read_sequence(std::vector<V1>, std::vector<V2>, std::vector<V3>)
       cmmfile.read_sequence(std::vector<V1>, std::vector<V2>, std::vector<V3>, std::vector<V4>)
 
+      // any number of columns fixed at compile time (C++11)
+      CMMFile::sequence<int, std::vector<double> > seq(cmmfile);
+      seq.write_header();   seq.write(i, v);   seq.write_batch(std::vector<int>, std::vector< std::vector<double> >);
+      seq.read_header();    while (seq.read(i, v)) ...
+
+   io backends (posix only, default is the filebuf of fstream, the async backend needs C++11)
+      cmmfile.set_backend(CMMFile::backend_posix, buffer_size, sequential);
+      cmmfile.set_backend(CMMFile::backend_mmap);        // read only
+      cmmfile.set_backend(CMMFile::backend_async, size); // writer thread, close() writes all data
+
+   fixed width numbers: float 'F', signed char 'c', short 's', int 'I', long long 'l',
+   unsigned char 'o', unsigned short 'w', unsigned int 'u', unsigned long long 'q'
+      the code follows the C++ type, on LP64 int64_t and uint64_t are long and unsigned long
+      and are written as 'L' and 'U', use long long or unsigned long long for 'l' and 'q',
+      Matlab writes int64 and uint64 as 'l' and 'q' (formerly 'L' and 'U'), readers
+      without these types cannot read such files
+      cmmfile << std::vector<float>;   cmmfile >> std::vector<double>;   // numbers are converted
+
+   length prefixed text (type 'P'), read transparently with >>
+      cmmfile.write_prefixed(std::vector<std::string>);
+
+   bit packed bools (type 'b'), read transparently with >>
+      cmmfile.write_bits(std::vector<bool>);
+
+   xor delta coded double columns in sequences (type 'X')
+      cmmfile.write_header_sequence_xor();   // write_data_sequence(double) as usual
+
+   delta varint coded integers (type 'V'), read transparently with >>
+      cmmfile.write_varint(std::vector<int>);
+      cmmfile.write_header_sequence_varint(-1);   // sequence column
+
+   lossy storage of doubles, half 'H', bfloat16 'G', 8 / 16 bit quantized 'Q', read with >>
+      cmmfile.write_half(std::vector<double>);   cmmfile.write_quantized(std::vector<double>, bits);
+
+   tiled arrays (type 'M') and reading parts of arrays
+      cmmfile.write_tiled(std::vector<double>, dim, tile);
+      cmmfile.read_hyperslab(std::vector<double>, cmmfile.get_entry(n), start, count, stride);
+
+   sequences column wise, values of all records in one buffer, offsets for -1 columns
+      CMMFile_column<double> c1;   CMMFile_column<int> c2;
+      cmmfile.read_columns(c1, c2);   c2.values[c2.offset(i) + k], k < c2.length(i)
+
+   reading into caller memory or vectors that are not zero filled
+      n = cmmfile.read_into(double*, capacity);
+      std::vector<double, CMMFile_default_init_allocator<double> > v;   cmmfile >> v;
+      std::pmr::vector<double> v(cmmfile.arena());   cmmfile >> v;   // C++17
+
+   matrices in one aligned block, also as sequence columns
+      CMMFile_matrix<double> m(rows, cols);   cmmfile << m;   cmmfile >> m;   m(i, j)
+
+   entries of any dimension in one aligned block
+      CMMFile_tensor<double> t;   cmmfile >> t;   t.shape, t.data()
+      cmmfile.read_tensor(double*, shape);   // shape checked against the header
+
+   reading nr and skipping ns values of vectors or rows of matrices
+      cmmfile.read_skip(std::vector<double>, nr, ns);
+
+   compressed numeric data (type 'Z'), read transparently with >>
+      cmmfile.set_compression(chunk_size, threads);
+      cmmfile.write_compressed(std::vector<double>);
+      cmmfile.read_range(std::vector<double>, first, count);   // only needed chunks
+
+   dictionary coded text (type 'D'), read transparently with >>
+      cmmfile.write_dictionary(std::vector<std::string>);
+      cmmfile.read_dictionary(std::vector<int> codes, CMMFile::string_list dict);
+
+   strings of an entry in one buffer without allocation per string
+      CMMFile::string_list l;  cmmfile >> l;  l[i], l.length(i)
+
+   index of entries for random access, written at close
+      cmmfile.set_index(true);
+      cmmfile.seek_entry(n);   cmmfile.entry_count();
+      the index is stored as two 'l' entries at the end, readers older than the 'l' type
+      (C++, cmm_read_file.m, CMMFile.m) fail on them or return them as data
+
+   prefetching of entries in the background (posix and C++11 only, io_uring on linux)
+      CMMFile_prefetch pf(cmmfile, depth);
+      pf >> dat1 >> dat2;
+
+   reading all entries with several threads (posix and C++11 only)
+      std::vector<CMMFile::value> vals;
+      cmmfile.read_all_parallel(vals);   vals[i].h, vals[i].data<double>()
+      memory backends are decoded in place, missing data sets failbit
+
+   following a file that is still written (posix and C++11 only)
+      CMMFile_follow fl(filename);   while (fl.wait(timeout)) fl.poll(std::vector<double>);
+
+   memory mapped reading (posix only)
+      cmmfile.open_read_mmap(filename);
+      CMMFile_view<double> d = cmmfile.read_view<double>(dim);   // no copy, d[i], valid until close()
+
    Christoph Kirst
    christoph@nld.ds.mpg.de 
    Max Planck Institue for Dynamics and Self-Organisation
@@ -70,216 +161,3124 @@
 #include <iostream>
 
 #include <fstream>
+#include <string>
 #include <vector>
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <new>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define CMMFile_PMR
+#include <memory_resource>
+#endif
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+// the words of a libstdc++ std::vector<bool> hold value i in bit i, on little endian
+// machines their bytes have the layout of bit packed bools and are copied as a whole
+#if defined(__GLIBCXX__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define CMMFile_BITWORDS
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CMMFile_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#endif
+
+// threads for the async backend, parallel compression and reading and prefetching
+// (C++11, posix only), define CMMFile_NO_THREADS to build without them
+#if defined(CMMFile_POSIX) && __cplusplus >= 201103L && !defined(CMMFile_NO_THREADS)
+#define CMMFile_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#endif
+
+#if defined(CMMFile_THREADS) && defined(__linux__) && defined(__has_include) && !defined(CMMFile_NO_IO_URING)
+#if __has_include(<linux/io_uring.h>)
+#define CMMFile_IO_URING
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
 
 // datatypes header
 #define CMMFile_TYPETYPE char
 #define CMMFile_INTG 'I'
 #define CMMFile_REAL 'R'
 #define CMMFile_TEXT 'T'
+#define CMMFile_PTXT 'P'   // length prefixed text
+#define CMMFile_DTXT 'D'   // dictionary coded text
 #define CMMFile_LONG 'L'
 #define CMMFile_ULNG 'U'
 
+// fixed width numbers, CMMFile_INTG is int32
+#define CMMFile_FLT32  'F'   // float
+#define CMMFile_INT8   'c'   // signed char
+#define CMMFile_INT16  's'   // short
+#define CMMFile_INT64  'l'   // long long, int64_t is long ('L') on LP64
+#define CMMFile_UINT8  'o'   // unsigned char
+#define CMMFile_UINT16 'w'   // unsigned short
+#define CMMFile_UINT32 'u'   // unsigned int
+#define CMMFile_UINT64 'q'   // unsigned long long, uint64_t is unsigned long ('U') on LP64
+
 #define CMMFile_BOOL 'B'
 #define CMMFile_TRUE 't'
 #define CMMFile_FALSE 'f' 
+#define CMMFile_BITS 'b'   // bit packed bool
+#define CMMFile_ZIPD 'Z'   // chunked compressed data
+#define CMMFile_XREL 'X'   // xor delta coded real, sequences only
+#define CMMFile_VINT 'V'   // delta varint coded integers
+#define CMMFile_TILE 'M'   // tiled array
+#define CMMFile_HALF 'H'   // IEEE half precision real
+#define CMMFile_BF16 'G'   // bfloat16 real
+#define CMMFile_QUANT 'Q'  // quantized real, 8 or 16 bit codes with offset and scale
 
 #define CMMFile_SEQS 'S'
 #define CMMFile_SEQE 'E'
 
-// dimension / size type
-#define CMMFile_DIMTYPE int
-#define CMMFile_SIZETYPE int
+// end of file index ("CMMIDX")
+#define CMMFile_INDEX_MAGIC 0x5844494D4D43L
+
+// buffer size of the posix backend
+#define CMMFile_BUFFERSIZE (1 << 20)
+
+// offsets and lengths inside data
+#define CMMFile_OFFSETTYPE long long
+
+// dimension / size type
+#define CMMFile_DIMTYPE int
+#define CMMFile_SIZETYPE int
+
+// alignment of CMMFile_aligned_allocator in bytes
+#define CMMFile_ALIGNMENT 64
+
+
+/****************************************************************************************
+   io backends
+      a backend is a stream buffer that replaces the filebuf of the fstream,
+      all reading / writing of CMMFile then goes through the backend
+         CMMFile_posixbuf:  file descriptor with large user sized buffer (pread/pwrite)
+         CMMFile_mmapbuf:   read only memory mapped file
+         CMMFile_asyncbuf:  write only, double buffered with a writer thread
+         CMMFile_membuf:    read only memory buffer
+      the default backend is the filebuf of std::fstream itself
+*****************************************************************************************/
+
+class CMMFile_backend : public std::streambuf {
+public:
+   virtual ~CMMFile_backend() {}
+   virtual bool open(const std::string & fn, std::ios::openmode mode) = 0;
+   virtual void close() = 0;
+   virtual bool is_open() const = 0;
+};
+
+
+// read only stream buffer on memory, e.g. a data entry read into a buffer
+class CMMFile_membuf : public CMMFile_backend {
+public:
+   CMMFile_membuf() : opened(false) {}
+
+   bool open(const std::string &, std::ios::openmode) { return false; }
+
+   bool attach(const char* data, size_t size)
+   {
+      setg((char *) data, (char *) data, (char *) data + size);
+      opened = true;
+      return true;
+   }
+
+   void close()
+   {
+      opened = false;
+      setg(0, 0, 0);
+   }
+
+   bool is_open() const { return opened; }
+   const char* data() const { return eback(); }
+   size_t size() const { return egptr() - eback(); }
+
+protected:
+   pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode)
+   {
+      char* p;
+      switch (dir) {
+         case std::ios_base::beg: p = eback() + off; break;
+         case std::ios_base::cur: p = gptr() + off; break;
+         default:                 p = egptr() + off; break;
+      }
+      if (p < eback() || p > egptr()) return pos_type(off_type(-1));
+      setg(eback(), p, egptr());
+      return pos_type(off_type(p - eback()));
+   }
+
+   pos_type seekpos(pos_type pos, std::ios_base::openmode which)
+   {
+      return seekoff(off_type(pos), std::ios_base::beg, which);
+   }
+
+   std::streamsize showmanyc() { return egptr() - gptr(); }
+
+private:
+   bool opened;
+};
+
+
+#ifdef CMMFile_POSIX
+
+class CMMFile_posixbuf : public CMMFile_backend {
+public:
+   CMMFile_posixbuf() : fd(-1), buffer_size(CMMFile_BUFFERSIZE), sequential(true), 
+                        writing(false), append(false), offset(0) {}
+   ~CMMFile_posixbuf() { close(); }
+
+   // settings take effect at the next open
+   void set_buffer_size(size_t n) { buffer_size = n > 0 ? n : 1; }
+   void set_sequential(bool s) { sequential = s; }
+
+   bool open(const std::string & fn, std::ios::openmode mode)
+   {
+      close();
+      writing = (mode & std::ios::out) != 0;
+      append  = (mode & std::ios::app) != 0;
+      int flags = writing ? (O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC)) : O_RDONLY;
+      fd = ::open(fn.c_str(), flags, 0666);
+      if (fd < 0) return false;
+#ifdef POSIX_FADV_SEQUENTIAL
+      posix_fadvise(fd, 0, 0, sequential ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+#endif
+      buffer.resize(buffer_size);
+      offset = append ? file_size() : 0;
+      char* b = &buffer[0];
+      if (writing) setp(b, b + buffer.size()); else setg(b, b, b);
+      return true;
+   }
+
+   void close()
+   {
+      if (fd < 0) return;
+      if (writing) flush();
+      ::close(fd);
+      fd = -1;
+      setg(0, 0, 0);
+      setp(0, 0);
+      std::vector<char>().swap(buffer);
+   }
+
+   bool is_open() const { return fd >= 0; }
+   int descriptor() const { return fd; }
+
+protected:
+   int_type overflow(int_type c)
+   {
+      if (!writing || !flush()) return traits_type::eof();
+      if (!traits_type::eq_int_type(c, traits_type::eof())) {
+         *pptr() = traits_type::to_char_type(c);
+         pbump(1);
+      }
+      return traits_type::not_eof(c);
+   }
+
+   std::streamsize xsputn(const char* s, std::streamsize n)
+   {
+      if (!writing) return 0;
+      if (n > epptr() - pptr()) {
+         if (!flush()) return 0;
+         // large blocks bypass the buffer
+         if (n >= std::streamsize(buffer.size())) return write_raw(s, n) ? n : 0;
+      }
+      memcpy(pptr(), s, n);
+      pbump(int(n));
+      return n;
+   }
+
+   int sync() { return (!writing || flush()) ? 0 : -1; }
+
+   int_type underflow()
+   {
+      if (writing) return traits_type::eof();
+      if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+      offset += egptr() - eback();
+      char* b = &buffer[0];
+      ssize_t r = read_raw(b, buffer.size());
+      setg(b, b, b + (r > 0 ? r : 0));
+      if (r <= 0) return traits_type::eof();
+      return traits_type::to_int_type(*gptr());
+   }
+
+   std::streamsize xsgetn(char* s, std::streamsize n)
+   {
+      std::streamsize done = std::min<std::streamsize>(n, egptr() - gptr());
+      memcpy(s, gptr(), done);
+      gbump(int(done));
+      if (done == n) return n;
+
+      // large blocks bypass the buffer
+      if (n - done >= std::streamsize(buffer.size())) {
+         offset += egptr() - eback();
+         char* b = &buffer[0];
+         setg(b, b, b);
+         ssize_t r = read_raw(s + done, n - done);
+         if (r > 0) { done += r; offset += r; }
+         return done;
+      }
+
+      while (done < n && !traits_type::eq_int_type(underflow(), traits_type::eof())) {
+         std::streamsize k = std::min<std::streamsize>(n - done, egptr() - gptr());
+         memcpy(s + done, gptr(), k);
+         gbump(int(k));
+         done += k;
+      }
+      return done;
+   }
+
+   std::streamsize showmanyc() { return egptr() - gptr(); }
+
+   pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode)
+   {
+      if (fd < 0) return pos_type(off_type(-1));
+      if (writing) {
+         off_type cur = offset + (pptr() - pbase());
+         if (dir == std::ios_base::cur && off == 0) return pos_type(cur);
+         if (append || !flush()) return pos_type(off_type(-1));
+         off_type target = (dir == std::ios_base::beg) ? off : (dir == std::ios_base::cur) ? cur + off : file_size() + off;
+         if (target < 0) return pos_type(off_type(-1));
+         offset = target;
+         return pos_type(target);
+      }
+
+      off_type cur = offset + (gptr() - eback());
+      off_type target = (dir == std::ios_base::beg) ? off : (dir == std::ios_base::cur) ? cur + off : file_size() + off;
+      if (target < 0) return pos_type(off_type(-1));
+      if (target >= offset && target <= offset + (egptr() - eback())) {
+         setg(eback(), eback() + (target - offset), egptr());
+      } else {
+         offset = target;
+         char* b = &buffer[0];
+         setg(b, b, b);
+      }
+      return pos_type(target);
+   }
+
+   pos_type seekpos(pos_type pos, std::ios_base::openmode which)
+   {
+      return seekoff(off_type(pos), std::ios_base::beg, which);
+   }
+
+private:
+   int fd;
+   size_t buffer_size;
+   bool sequential;
+   bool writing;
+   bool append;
+   off_t offset;              // file position of start of buffer
+   std::vector<char> buffer;
+
+   off_t file_size()
+   {
+      struct stat st;
+      if (fstat(fd, &st) != 0) return 0;
+      return st.st_size;
+   }
+
+   // write pending data in put area
+   bool flush()
+   {
+      bool ok = write_raw(pbase(), pptr() - pbase());
+      setp(pbase(), epptr());
+      return ok;
+   }
+
+   bool write_raw(const char* s, size_t n)
+   {
+      while (n > 0) {
+         ssize_t w = append ? ::write(fd, s, n) : ::pwrite(fd, s, n, offset);
+         if (w < 0 && errno == EINTR) continue;
+         if (w <= 0) return false;
+         s += w; n -= w; offset += w;
+      }
+      return true;
+   }
+
+   // read at offset without changing it, returns bytes read
+   ssize_t read_raw(char* s, size_t n)
+   {
+      size_t done = 0;
+      while (done < n) {
+         ssize_t r = ::pread(fd, s + done, n - done, offset + done);
+         if (r < 0 && errno == EINTR) continue;
+         if (r <= 0) break;
+         done += r;
+      }
+      return done;
+   }
+};
+
+
+class CMMFile_mmapbuf : public CMMFile_membuf {
+public:
+   CMMFile_mmapbuf() : map(0), map_size(0) {}
+   ~CMMFile_mmapbuf() { close(); }
+
+   bool open(const std::string & fn, std::ios::openmode mode = std::ios::in)
+   {
+      close();
+      if (mode & std::ios::out) return false;   // read only
+      int fd = ::open(fn.c_str(), O_RDONLY);
+      if (fd < 0) return false;
+      struct stat st;
+      if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+      map_size = st.st_size;
+      if (map_size > 0) {
+         void* p = mmap(0, map_size, PROT_READ, MAP_SHARED, fd, 0);
+         if (p == MAP_FAILED) { ::close(fd); map_size = 0; return false; }
+         map = (char *) p;
+      }
+      ::close(fd);
+      return attach(map, map_size);
+   }
+
+   void close()
+   {
+      CMMFile_membuf::close();
+      if (map) munmap(map, map_size);
+      map = 0; map_size = 0;
+   }
+
+private:
+   char* map;
+   size_t map_size;
+};
+
+
+#ifdef CMMFile_THREADS
+// write only, data is collected in one of two buffers while a writer thread
+// writes the other one to the file, a full buffer waits for the writer
+class CMMFile_asyncbuf : public CMMFile_backend {
+public:
+   CMMFile_asyncbuf() : fd(-1), buffer_size(CMMFile_BUFFERSIZE), append(false), offset(0),
+                        active(0), pending(false), failed(false), stop(false) {}
+   ~CMMFile_asyncbuf() { close(); }
+
+   // takes effect at the next open, two buffers of this size are allocated
+   void set_buffer_size(size_t n) { buffer_size = n > 0 ? n : 1; }
+
+   bool open(const std::string & fn, std::ios::openmode mode)
+   {
+      close();
+      if (!(mode & std::ios::out)) return false;   // write only
+      append = (mode & std::ios::app) != 0;
+      fd = ::open(fn.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0666);
+      if (fd < 0) return false;
+      offset = 0;
+      if (append) {
+         struct stat st;
+         if (fstat(fd, &st) == 0) offset = st.st_size;
+      }
+      for (int i = 0; i < 2; i++) buffer[i].resize(buffer_size);
+      active = 0;
+      pending = false;
+      failed = false;
+      stop = false;
+      setp(&buffer[0][0], &buffer[0][0] + buffer_size);
+      writer = std::thread(&CMMFile_asyncbuf::run, this);
+      return true;
+   }
+
+   // writes all data and stops the writer thread
+   void close()
+   {
+      if (fd < 0) return;
+      drain();
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         stop = true;
+      }
+      cond.notify_all();
+      writer.join();
+      ::close(fd);
+      fd = -1;
+      setp(0, 0);
+      for (int i = 0; i < 2; i++) std::vector<char>().swap(buffer[i]);
+   }
+
+   bool is_open() const { return fd >= 0; }
+
+protected:
+   int_type overflow(int_type c)
+   {
+      if (!submit()) return traits_type::eof();
+      if (!traits_type::eq_int_type(c, traits_type::eof())) {
+         *pptr() = traits_type::to_char_type(c);
+         pbump(1);
+      }
+      return traits_type::not_eof(c);
+   }
+
+   std::streamsize xsputn(const char* s, std::streamsize n)
+   {
+      std::streamsize done = 0;
+      while (done < n) {
+         if (pptr() == epptr() && !submit()) break;
+         std::streamsize k = std::min<std::streamsize>(n - done, epptr() - pptr());
+         memcpy(pptr(), s + done, k);
+         pbump(int(k));
+         done += k;
+      }
+      return done;
+   }
+
+   // data is written to the file when sync returns
+   int sync() { return (fd >= 0 && drain()) ? 0 : -1; }
+
+   pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode)
+   {
+      if (fd < 0) return pos_type(off_type(-1));
+      off_type cur = offset + (pptr() - pbase());
+      if (dir == std::ios_base::cur && off == 0) return pos_type(cur);
+      if (append || !drain()) return pos_type(off_type(-1));
+      struct stat st;
+      off_type end = fstat(fd, &st) == 0 ? st.st_size : 0;
+      off_type target = (dir == std::ios_base::beg) ? off : (dir == std::ios_base::cur) ? cur + off : end + off;
+      if (target < 0) return pos_type(off_type(-1));
+      offset = target;
+      return pos_type(target);
+   }
+
+   pos_type seekpos(pos_type pos, std::ios_base::openmode which)
+   {
+      return seekoff(off_type(pos), std::ios_base::beg, which);
+   }
+
+private:
+   int fd;
+   size_t buffer_size;
+   bool append;
+   off_t offset;                // file position of start of active buffer
+   std::vector<char> buffer[2];
+   int active;                  // buffer filled by the stream
+
+   std::thread writer;
+   std::mutex mutex;
+   std::condition_variable cond;
+   bool pending;                // other buffer waits for / is being written
+   const char* pending_data;
+   size_t pending_size;
+   off_t pending_offset;
+   bool failed;
+   bool stop;
+
+   // hand the active buffer to the writer, waits while the other buffer is written
+   bool submit()
+   {
+      size_t n = pptr() - pbase();
+      std::unique_lock<std::mutex> lock(mutex);
+      while (pending) cond.wait(lock);
+      if (failed) return false;
+      if (n > 0) {
+         pending_data = pbase();
+         pending_size = n;
+         pending_offset = offset;
+         pending = true;
+         offset += n;
+         active = 1 - active;
+         cond.notify_all();
+      }
+      char* b = &buffer[active][0];
+      setp(b, b + buffer_size);
+      return true;
+   }
+
+   // write all data
+   bool drain()
+   {
+      if (!submit()) return false;
+      std::unique_lock<std::mutex> lock(mutex);
+      while (pending) cond.wait(lock);
+      return !failed;
+   }
+
+   void run()
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+         while (!pending && !stop) cond.wait(lock);
+         if (!pending) return;
+         const char* s = pending_data;
+         size_t n = pending_size;
+         off_t o = pending_offset;
+         lock.unlock();
+         bool ok = true;
+         while (n > 0) {
+            ssize_t w = append ? ::write(fd, s, n) : ::pwrite(fd, s, n, o);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) { ok = false; break; }
+            s += w; n -= w; o += w;
+         }
+         lock.lock();
+         if (!ok) failed = true;
+         pending = false;
+         cond.notify_all();
+      }
+   }
+};
+#endif
+#endif
+
+
+/****************************************************************************************
+   aligned arrays
+      CMMFile_aligned_allocator allocates at CMMFile_ALIGNMENT byte boundaries
+      CMMFile_default_init_allocator does not value initialize (C++11)
+      CMMFile_matrix is a contiguous row major matrix
+      CMMFile_tensor is a contiguous row major array of any dimension and its shape
+*****************************************************************************************/
+
+template<typename V>
+class CMMFile_aligned_allocator {
+public:
+   typedef V value_type;
+   typedef V* pointer;
+   typedef const V* const_pointer;
+   typedef V& reference;
+   typedef const V& const_reference;
+   typedef size_t size_type;
+   typedef ptrdiff_t difference_type;
+   template<typename U> struct rebind { typedef CMMFile_aligned_allocator<U> other; };
+
+   CMMFile_aligned_allocator() {}
+   template<typename U> CMMFile_aligned_allocator(const CMMFile_aligned_allocator<U>&) {}
+
+   pointer address(reference v) const { return &v; }
+   const_pointer address(const_reference v) const { return &v; }
+   size_type max_size() const { return size_type(-1) / sizeof(V); }
+   void construct(pointer p, const V& v) { new((void *) p) V(v); }
+   void destroy(pointer p) { p->~V(); }
+
+   // the allocated block is kept in front of the aligned memory
+   pointer allocate(size_type n, const void* = 0) {
+      char* m = (char *) ::operator new(n * sizeof(V) + CMMFile_ALIGNMENT + sizeof(void*));
+      char* a = m + sizeof(void*);
+      a += (CMMFile_ALIGNMENT - size_t(a) % CMMFile_ALIGNMENT) % CMMFile_ALIGNMENT;
+      ((void **) a)[-1] = m;
+      return (pointer) a;
+   }
+
+   void deallocate(pointer p, size_type) {
+      if (p) ::operator delete(((void **) p)[-1]);
+   }
+
+   template<typename U> bool operator==(const CMMFile_aligned_allocator<U>&) const { return true; }
+   template<typename U> bool operator!=(const CMMFile_aligned_allocator<U>&) const { return false; }
+};
+
+
+template<typename V>
+class CMMFile_tensor {
+public:
+   std::vector<CMMFile_SIZETYPE> shape;
+   std::vector<V, CMMFile_aligned_allocator<V> > values;
+
+   CMMFile_tensor() {}
+   CMMFile_tensor(const std::vector<CMMFile_SIZETYPE>& s) { resize(s); }
+
+   void resize(const std::vector<CMMFile_SIZETYPE>& s) {
+      shape = s;
+      size_t n = 1;
+      for (size_t d = 0; d < s.size(); d++) {
+         assert(s[d] >= 0);
+         n *= s[d];
+      }
+      values.resize(n);
+   }
+
+   CMMFile_DIMTYPE dim() const { return CMMFile_DIMTYPE(shape.size()); }
+   size_t size() const { return values.size(); }
+   V* data() { return values.empty() ? (V *) 0 : &values[0]; }
+   const V* data() const { return values.empty() ? (const V *) 0 : &values[0]; }
+   V& operator[](size_t i) { return values[i]; }
+   const V& operator[](size_t i) const { return values[i]; }
+};
+
+
+#if __cplusplus >= 201103L
+// allocator leaving values default initialized, e.g. resize does not zero fill doubles
+template<typename V, typename A = std::allocator<V> >
+class CMMFile_default_init_allocator : public A {
+public:
+   template<typename U> struct rebind {
+      typedef CMMFile_default_init_allocator<U, typename std::allocator_traits<A>::template rebind_alloc<U> > other;
+   };
+
+   using A::A;
+
+   template<typename U>
+   void construct(U* p) { ::new((void *) p) U; }
+
+   template<typename U, typename... Args>
+   void construct(U* p, Args&&... args) {
+      std::allocator_traits<A>::construct(static_cast<A&>(*this), p, std::forward<Args>(args)...);
+   }
+};
+#endif
+
+
+// contiguous row major matrix
+template<typename V>
+class CMMFile_matrix {
+public:
+   CMMFile_SIZETYPE rows, cols;
+   std::vector<V, CMMFile_aligned_allocator<V> > values;
+
+   CMMFile_matrix() : rows(0), cols(0) {}
+   CMMFile_matrix(CMMFile_SIZETYPE r, CMMFile_SIZETYPE c) : rows(0), cols(0) { resize(r, c); }
+
+   void resize(CMMFile_SIZETYPE r, CMMFile_SIZETYPE c) {
+      assert(r >= 0 && c >= 0);
+      rows = r;
+      cols = c;
+      values.resize(size_t(r) * c);
+   }
+
+   size_t size() const { return values.size(); }
+   V* data() { return values.empty() ? (V *) 0 : &values[0]; }
+   const V* data() const { return values.empty() ? (const V *) 0 : &values[0]; }
+   V* operator[](CMMFile_SIZETYPE i) { return data() + size_t(i) * cols; }
+   const V* operator[](CMMFile_SIZETYPE i) const { return data() + size_t(i) * cols; }
+   V& operator()(CMMFile_SIZETYPE i, CMMFile_SIZETYPE j) { return values[size_t(i) * cols + j]; }
+   const V& operator()(CMMFile_SIZETYPE i, CMMFile_SIZETYPE j) const { return values[size_t(i) * cols + j]; }
+};
+
+
+// one column of a sequence read column wise (see CMMFile::read_columns),
+// the values of all records in one buffer, record i is values[offset(i) ... offset(i) + length(i))
+template<typename V>
+class CMMFile_column {
+public:
+   std::vector<V> values;
+   std::vector<CMMFile_OFFSETTYPE> offsets;   // records + 1 offsets for records of variable size
+   CMMFile_SIZETYPE stride;                   // values per record, 0 for variable size or no values
+
+   CMMFile_column() : stride(0) {}
+
+   size_t records() const { return stride > 0 ? values.size() / stride : (offsets.empty() ? 0 : offsets.size() - 1); }
+   size_t offset(size_t i) const { return stride > 0 ? i * stride : offsets[i]; }
+   size_t length(size_t i) const { return stride > 0 ? stride : offsets[i+1] - offsets[i]; }
+};
+
+
+// values of an entry in a mapped file (see CMMFile::read_view), headers are packed so the
+// data is in general not aligned for V, values are loaded with memcpy
+template<typename V>
+class CMMFile_view {
+public:
+   CMMFile_view(const char* b = 0) : bytes(b) {}
+
+   V operator[](size_t i) const {
+      V v;
+      memcpy(&v, bytes + i * sizeof(V), sizeof(V));
+      return v;
+   }
+
+   const char* data() const { return bytes; }
+
+private:
+   const char* bytes;
+};
+
+
+// numbers (arithmetic types but bool), only they are converted and delta, varint or tile
+// coded; call sites that depend on the type in the file select code with CMMFile_tag
+template<typename V> struct CMMFile_numeric { static const bool value = std::numeric_limits<V>::is_specialized; };
+template<> struct CMMFile_numeric<bool> { static const bool value = false; };
+
+template<typename V> struct CMMFile_integer { static const bool value = std::numeric_limits<V>::is_integer; };
+template<> struct CMMFile_integer<bool> { static const bool value = false; };
+
+template<bool B> struct CMMFile_tag {};
+
+// compile time check in a function body
+#if __cplusplus >= 201103L
+#define CMMFile_STATIC_ASSERT(c, msg) static_assert(c, msg)
+#else
+#define CMMFile_STATIC_ASSERT(c, msg) (void) sizeof(char[(c) ? 1 : -1])
+#endif
+
+
+class CMMFile : public std::fstream {
+public:
+   std::string filename;
+
+   typedef const char * cstr_type;
+
+   struct header {
+      CMMFile_TYPETYPE type;
+      std::vector<CMMFile_SIZETYPE> dim;
+      double last[2];   // last two values of a CMMFile_XREL sequence column
+
+      header() : type(0) { last[0] = last[1] = 0; }
+   };
+
+   // position of a data entry in the file
+   struct entry {
+      header h;
+      std::streamoff offset;   // start of header
+      std::streamoff data;     // start of data
+      std::streamoff end;      // end of data
+   };
+
+public:
+   // io backends, see CMMFile_backend
+   enum backend_type { backend_fstream, backend_posix, backend_mmap, backend_async };
+
+   CMMFile() : filename(""), io_type(backend_fstream), io(0), io_mode(std::ios::in), 
+               compression_chunk(CMMFile_BUFFERSIZE), compression_threads(0),
+               index_on_close(false), index_loaded(false), index_offset(-1),
+               index_pending(false), index_open_ended(false) {}
+   ~CMMFile() { close(); }
+
+   // select backend for the following open_* calls,
+   // buffer size and access hint (sequential / random) are used by the posix backend,
+   // the async backend writes with two buffers of buffer size and reads with the posix backend
+   void set_backend(backend_type t, size_t buffer_size = CMMFile_BUFFERSIZE, bool sequential = true)
+   {
+#ifndef CMMFile_POSIX
+      assert(t == backend_fstream);
+#else
+      posixbuf.set_buffer_size(buffer_size);
+      posixbuf.set_sequential(sequential);
+#ifdef CMMFile_THREADS
+      if (t == backend_async && !asyncbuf) asyncbuf.reset(new CMMFile_asyncbuf());
+      if (asyncbuf) asyncbuf->set_buffer_size(buffer_size);
+#endif
+#endif
+      io_type = t;
+   }
+
+   backend_type backend() const { return io_type; }
+
+   bool open_write(const std::string & fn)
+   {
+      return open_backend(fn, std::ios::out | std::ios::binary);
+   }
+   
+   bool open_write_append(const std::string & fn)
+   {
+      // an index is only valid at the end of the file, it is removed and written again at close
+      std::vector<entry> es;
+      std::streamoff end = -1;
+      CMMFile r;
+      if (r.open_read(fn)) {
+         if (r.has_index()) {
+            es = r.index;
+            end = r.index_offset;
+         } else if (index_on_close) {
+            r.scan_entries(es);
+         }
+         r.close();
+      }
+      if (end >= 0 && !truncate_file(fn, end)) return false;
+      if (!open_backend(fn, std::ios::out | std::ios::binary | std::ios::app)) return false;
+      written = es;
+      if (!es.empty()) {
+         const header& h = es.back().h;
+         index_open_ended = h.type == CMMFile_SEQS || (h.dim.size() > 0 && h.dim[0] == -1);
+      }
+      // tellp of an appending filebuf is the end of the file only after the first write
+      if (index_on_close && !io) seekp(0, std::ios_base::end);
+      return true;
+   }
+   
+
+   bool open_read(const std::string & fn)
+   {
+      return open_backend(fn, std::ios::in | std::ios::binary);
+   }
+
+#ifdef CMMFile_POSIX
+   // read only, the stream reads from a mapping of the file (see read_view)
+   bool open_read_mmap(const std::string & fn)
+   {
+      return open_backend(fn, std::ios::in | std::ios::binary, &mmapbuf);
+   }
+
+   bool is_mmap() const { return io == &mmapbuf; }
+#endif
+
+   // read only, the stream reads from the given memory which must stay valid until close()
+   bool open_read_memory(const char* data, size_t size)
+   {
+      close();
+      io_mode = std::ios::in;
+      membuf.attach(data, size);
+      io = &membuf;
+      std::basic_ios<char>::rdbuf(io);
+      return std::fstream::good();
+   }
+
+   bool is_open() { return io ? io->is_open() : std::fstream::is_open(); }
+
+   void close()
+   {
+      if (index_on_close && (io_mode & std::ios::out) && is_open()) write_index();
+      index.clear();
+      index_loaded = false;
+      index_offset = -1;
+      written.clear();
+      index_pending = false;
+      index_open_ended = false;
+      if (io) {
+         // buffered data that cannot be written sets failbit
+         bool ok = !(io_mode & std::ios::out) || io->pubsync() == 0;
+         std::basic_ios<char>::rdbuf(std::fstream::rdbuf());
+         io->close();
+         io = 0;
+         if (!ok) setstate(std::ios::failbit);
+      } else {
+         std::fstream::close();
+      }
+      filename = "";
+   }
+
+   // writes buffered data, sets failbit if it cannot be written
+   int sync()
+   {
+      if (std::basic_ios<char>::rdbuf()->pubsync() == 0) return 0;
+      setstate(std::ios::failbit);
+      return -1;
+   }
+
+private:
+   backend_type io_type;
+   CMMFile_backend* io;   // active backend, 0 for the fstream filebuf
+   CMMFile_membuf membuf;
+   std::ios::openmode io_mode;
+#ifdef CMMFile_POSIX
+   CMMFile_posixbuf posixbuf;
+   CMMFile_mmapbuf mmapbuf;
+#endif
+#ifdef CMMFile_THREADS
+   std::unique_ptr<CMMFile_asyncbuf> asyncbuf;   // created when backend_async is selected
+#endif
+
+   // memory of memory mapped or memory backend, 0 otherwise
+   CMMFile_membuf* memory()
+   {
+#ifdef CMMFile_POSIX
+      if (io == &mmapbuf) return &mmapbuf;
+#endif
+      return io == &membuf ? &membuf : 0;
+   }
+
+   bool open_backend(const std::string & fn, std::ios::openmode mode, CMMFile_backend* b = 0)
+   {
+      filename = fn;
+      io_mode = mode;
+#ifdef CMMFile_POSIX
+      if (!b && io_type == backend_posix) b = &posixbuf;
+      if (!b && io_type == backend_mmap)  b = &mmapbuf;
+#ifdef CMMFile_THREADS
+      if (!b && io_type == backend_async) b = (mode & std::ios::out) ? (CMMFile_backend*) asyncbuf.get() : &posixbuf;
+#else
+      if (!b && io_type == backend_async) b = &posixbuf;
+#endif
+#endif
+      if (!b) {
+         std::fstream::open(filename.c_str(), mode);
+         return std::fstream::good();
+      }
+      if (!b->open(filename, mode)) {
+         setstate(std::ios::failbit);
+         return false;
+      }
+      io = b;
+      std::basic_ios<char>::rdbuf(io);
+      return std::fstream::good();
+   }
+
+public:
+/****************************************************************************************
+   size of types
+*****************************************************************************************/
+
+   int size_of(CMMFile_TYPETYPE type) {
+      switch (type) {
+         case CMMFile_REAL: return sizeof(double);
+         case CMMFile_INTG: return sizeof(int);
+         case CMMFile_LONG: return sizeof(long);
+         case CMMFile_ULNG: return sizeof(unsigned long);
+         case CMMFile_FLT32:  return 4;
+         case CMMFile_INT8:   return 1;
+         case CMMFile_INT16:  return 2;
+         case CMMFile_INT64:  return 8;
+         case CMMFile_UINT8:  return 1;
+         case CMMFile_UINT16: return 2;
+         case CMMFile_UINT32: return 4;
+         case CMMFile_UINT64: return 8;
+         case CMMFile_HALF:   return 2;
+         case CMMFile_BF16:   return 2;
+         case CMMFile_TEXT: return sizeof(char);  // null terminated string -> size of one character  !
+         case CMMFile_BOOL: return sizeof(char);
+         default:  std::cout << "Unknow Type:" << type << std::endl;
+                   assert((type ==CMMFile_REAL) || (type ==CMMFile_INTG) || (type ==CMMFile_LONG) 
+                      || (type ==CMMFile_ULNG) || (type ==CMMFile_TEXT) || (type ==CMMFile_BOOL));
+      }
+   }
+
+   static bool is_numeric(CMMFile_TYPETYPE type) {
+      switch (type) {
+         case CMMFile_REAL:  case CMMFile_INTG:  case CMMFile_LONG:   case CMMFile_ULNG:
+         case CMMFile_FLT32: case CMMFile_INT8:  case CMMFile_INT16:  case CMMFile_INT64:
+         case CMMFile_UINT8: case CMMFile_UINT16: case CMMFile_UINT32: case CMMFile_UINT64:
+         case CMMFile_HALF:  case CMMFile_BF16:  case CMMFile_QUANT:   // lossy reals
+            return true;
+         default:
+            return false;
+      }
+   }
+
+   // calculate number of remaining data points for use with -1 dimensons
+   template <typename V>
+   void tell_size(CMMFile_SIZETYPE& size)
+   {
+      std::streampos pos = tellg();
+      seekg(0, ios_base::end);
+      std::streampos end = tellg();
+      seekg(pos, ios_base::beg);
+      size = CMMFile_SIZETYPE((end-pos)/sizeof(V));
+   }
+
+   template <typename V>
+   void tell_size(CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
+      tell_size<V>(size1);
+      size1 = CMMFile_SIZETYPE(size1/size2);
+   }
+
+   // number of entries gived dimensions d
+   inline CMMFile_SIZETYPE length(std::vector<CMMFile_SIZETYPE> d) {
+      CMMFile_SIZETYPE n=1;
+      for (CMMFile_DIMTYPE i=0; i<d.size(); i++) {
+         n*=d[i];
+      }
+      return n;
+   }
+
+public:
+/****************************************************************************************
+   writing raw data 
+*****************************************************************************************/
+
+   template<typename V>
+   inline void write_data(const V& v)
+   {
+      std::fstream::write( (char *) &v, sizeof(V) );
+   }
+
+   template<typename V>
+   inline void write_data(const std::vector<V>& v)
+   {
+      if (v.size() > 0) std::fstream::write( (char *) &v[0], v.size() * sizeof(V) );
+   }
+
+
+   template<typename V>
+   inline void write_data(const std::vector< std::vector<V> >& v) {
+      CMMFile_SIZETYPE size = v.empty() ? 0 : v[0].size();
+      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(size == it->size());
+      }
+      if (size == 0) return;
+      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         std::fstream::write( (char *) &((*it)[0]), size  * sizeof(V) );
+      }
+   }
+
+
+   template<typename V, typename S>
+   inline void write_data(const V* v, const S& size) {
+      std::fstream::write( (char *) v, size * sizeof(V) );
+   }
+
+   template<typename V, typename S>
+   inline void write_data(const V** v, const S& size1, const S& size2) {
+      for (S i = 0; i < size1; i++) {
+         std::fstream::write( (char *) v[i], size2  * sizeof(V) );
+      }
+   }
+
+
+public:
+/****************************************************************************************
+   reading raw data 
+*****************************************************************************************/
+
+
+   template<typename V>
+   inline void read_data(V& v) {
+      std::fstream::read((char *) & v , sizeof(V));
+   }
+
+   template<typename V, typename S>
+   inline void read_data(std::vector<V>& v, const S& size)
+   {
+      assert(size >= -1);
+      S s = size;
+      if (s<0) tell_size<V>(s);
+      v.resize(s);
+      if (s > 0) std::fstream::read((char *) & v[0] , s*sizeof(V));
+   }
+
+   template<typename V, typename S>
+   inline void read_data(std::vector< std::vector<V> >& v, const S& size1, const S& size2)
+   {
+      assert(size1 >= -1);
+      S s = size1;
+      if (s<0) tell_size<V>(s, size2);
+      v.resize(s);
+      for (typename std::vector< std::vector<V> >::iterator it = v.begin(); it != v.end(); it++)
+      {
+         it -> resize(size2);
+         std::fstream::read( (char *) &((*it)[0]), size2* sizeof(V) );
+      }
+   }
+
+   template<typename V, typename S>
+   inline void read_data(V*& v, const S& size)
+   {
+      assert(size >= -1);
+      S s = size;
+      if (s<0) tell_size<V>(s);
+      v = new V[s];
+      std::fstream::read((char *) & v[0] , s * sizeof(V));
+   }
+
+   template<typename V, typename S>
+   inline void read_data(V**& v, const S& size1, const S& size2)
+   {
+      assert(size1 >= -1);
+      S s = size1;
+      if (s==-1) tell_size<V>(s,size2);
+      v = new V*[s];
+      for (CMMFile_SIZETYPE i = 0; i< s; i++) {
+         v[i] = new V[size2];
+         std::fstream::read((char *) v[i] , size2 * sizeof(V));
+      }
+   }
+
+
+   // reading data stored with type t, which may be an alternative encoding of V
+   template<typename V>
+   inline void read_data_typed(const CMMFile_TYPETYPE& t, V& v) {
+      if (!is_type<V>(t) && is_numeric(t)) {
+         std::vector<V> w;
+         read_data_converted(t, w, 1, CMMFile_tag<CMMFile_numeric<V>::value>());
+         if (w.size() > 0) v = w[0];
+         return;
+      }
+      assert(is_type<V>(t));
+      read_data(v);
+   }
+
+   template<typename V, typename S>
+   inline void read_data_typed(const CMMFile_TYPETYPE& t, std::vector<V>& v, const S& size) {
+      if (t == CMMFile_ZIPD) {
+         read_data_compressed(v, size);
+         return;
+      }
+      if (t == CMMFile_VINT) {
+         read_data_varint(v, size);
+         return;
+      }
+      if (t == CMMFile_TILE) {
+         read_data_tiled(v, std::vector<CMMFile_SIZETYPE>(1, size), CMMFile_tag<CMMFile_numeric<V>::value>());
+         return;
+      }
+      if (!is_type<V>(t) && is_numeric(t)) {
+         read_data_converted(t, v, size, CMMFile_tag<CMMFile_numeric<V>::value>());
+         return;
+      }
+      assert(is_type<V>(t));
+      read_data(v, size);
+   }
+
+   template<typename V, typename S>
+   inline void read_data_typed(const CMMFile_TYPETYPE& t, std::vector< std::vector<V> >& v, const S& size1, const S& size2) {
+      if (t == CMMFile_ZIPD) {
+         read_data_compressed(v, size1, size2);
+         return;
+      }
+      if (t == CMMFile_VINT) {
+         read_data_varint(v, size1, size2);
+         return;
+      }
+      if (t == CMMFile_TILE) {
+         std::vector<CMMFile_SIZETYPE> dim(1, size1);
+         dim.push_back(size2);
+         std::vector<V> flat;
+         read_data_tiled(flat, dim, CMMFile_tag<CMMFile_numeric<V>::value>());
+         v.resize(size1);
+         for (S i = 0; i < size1; i++) {
+            v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+         }
+         return;
+      }
+      if (!is_type<V>(t) && is_numeric(t)) {
+         std::vector<V> flat;
+         read_data_converted(t, flat, size1 < 0 ? S(-1) : S(size1 * size2), CMMFile_tag<CMMFile_numeric<V>::value>());
+         S n = size2 > 0 ? S(flat.size() / size2) : 0;
+         v.resize(n);
+         for (S i = 0; i < n; i++) {
+            v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+         }
+         return;
+      }
+      assert(is_type<V>(t));
+      read_data(v, size1, size2);
+   }
+
+   // numbers stored with another numeric type t are converted to V, for text or bools V this
+   // is a type mismatch found at run time (failbit), converting to them directly does not compile
+   template<typename V, typename S>
+   inline void read_data_converted(const CMMFile_TYPETYPE&, std::vector<V>&, const S&, CMMFile_tag<false>) {
+      assert(!"converted entry needs numbers");
+      setstate(std::ios::failbit);
+   }
+
+   template<typename V, typename S>
+   inline void read_data_converted(const CMMFile_TYPETYPE& t, std::vector<V>& v, const S& size, CMMFile_tag<true>) {
+      switch (t) {
+         case CMMFile_REAL:   read_data_cast<double>(v, size); break;
+         case CMMFile_INTG:   read_data_cast<int>(v, size); break;
+         case CMMFile_LONG:   read_data_cast<long>(v, size); break;
+         case CMMFile_ULNG:   read_data_cast<unsigned long>(v, size); break;
+         case CMMFile_FLT32:  read_data_cast<float>(v, size); break;
+         case CMMFile_INT8:   read_data_cast<signed char>(v, size); break;
+         case CMMFile_INT16:  read_data_cast<short>(v, size); break;
+         case CMMFile_INT64:  read_data_cast<long long>(v, size); break;
+         case CMMFile_UINT8:  read_data_cast<unsigned char>(v, size); break;
+         case CMMFile_UINT16: read_data_cast<unsigned short>(v, size); break;
+         case CMMFile_UINT32: read_data_cast<unsigned int>(v, size); break;
+         case CMMFile_UINT64: read_data_cast<unsigned long long>(v, size); break;
+         case CMMFile_HALF:
+         case CMMFile_BF16:
+         case CMMFile_QUANT:  read_data_lossy(t, v, size); break;
+         default: assert(false);
+      }
+   }
+
+   template<typename W, typename V, typename S>
+   inline void read_data_cast(std::vector<V>& v, const S& size) {
+      std::vector<W> w;
+      read_data(w, size);
+      cast_values(w, v);
+   }
+
+   template<typename W, typename V>
+   static void cast_values(const std::vector<W>& w, std::vector<V>& v) { v.assign(w.begin(), w.end()); }
+
+
+public:
+/****************************************************************************************
+   lists of strings in a single buffer
+      the strings of a 'T' or 'P' entry are kept null terminated in one arena,
+      no allocation per string, l[i] is a c string valid as long as the list
+*****************************************************************************************/
+
+   struct string_list {
+      std::vector<char> arena;
+      std::vector<size_t> offsets;   // start of each string and end of last one
+
+      size_t size() const { return offsets.size() > 0 ? offsets.size() - 1 : 0; }
+      const char* operator[](size_t i) const { return &arena[offsets[i]]; }
+      size_t length(size_t i) const { return offsets[i+1] - offsets[i] - 1; }
+#if __cplusplus >= 201703L
+      std::string_view view(size_t i) const { return std::string_view(&arena[offsets[i]], length(i)); }
+#endif
+
+      void clear() { arena.clear(); offsets.assign(1, 0); }
+      void push_back(const std::string& s) {
+         if (offsets.empty()) offsets.push_back(0);
+         arena.insert(arena.end(), s.c_str(), s.c_str() + strlen(s.c_str()) + 1);
+         offsets.push_back(arena.size());
+      }
+   };
+
+   // append offsets of null terminated strings in data[begin, end) to o,
+   // a non terminated rest is terminated and counts as a string
+   static void split_strings(std::vector<char>& data, size_t begin, std::vector<size_t>& o) {
+      const char* p = data.empty() ? 0 : &data[0];
+      size_t pos = begin;
+      while (pos < data.size()) {
+         const char* z = (const char *) memchr(p + pos, '\0', data.size() - pos);
+         if (!z) {
+            data.push_back('\0');
+            pos = data.size();
+         } else {
+            pos = z - p + 1;
+         }
+         o.push_back(pos);
+      }
+   }
+
+   // read size null terminated strings, -1 reads the remaining file in one block
+   inline void read_data(string_list& l, const CMMFile_SIZETYPE& size) {
+      assert(size >= -1);
+      l.clear();
+      if (size < 0) {
+         CMMFile_SIZETYPE r;
+         tell_size<char>(r);
+         read_data(l.arena, r);
+         split_strings(l.arena, 0, l.offsets);
+         return;
+      }
+      std::string str;
+      for (CMMFile_SIZETYPE i = 0; i < size; i++) {
+         std::getline(*this, str, '\0');
+         l.arena.insert(l.arena.end(), str.begin(), str.end());
+         l.arena.push_back('\0');
+         l.offsets.push_back(l.arena.size());
+      }
+   }
+
+   // length prefixed strings, data is read with two reads
+   inline void read_data_prefixed(string_list& l, const CMMFile_SIZETYPE& size) {
+      assert(size >= -1);
+      CMMFile_OFFSETTYPE n;
+      read_data(n);
+      CMMFile_SIZETYPE s = size;
+      if (s < 0) {
+         CMMFile_SIZETYPE r;
+         tell_size<char>(r);
+         s = CMMFile_SIZETYPE((r - n) / sizeof(CMMFile_OFFSETTYPE));
+      }
+      std::vector<CMMFile_OFFSETTYPE> off;
+      read_data(off, s);
+      read_data(l.arena, CMMFile_SIZETYPE(n));
+      l.offsets.assign(off.begin(), off.end());
+      l.offsets.push_back(n);
+   }
+
+   // read 'T', 'P' or 'D' entry of any dimension as flat list
+   inline void read(string_list& l) {
+      header h;
+      read_header(h);
+      CMMFile_SIZETYPE n = length(h.dim);
+      if (h.dim.size() > 0 && h.dim[0] == -1) n = -1;
+      if (h.type == CMMFile_PTXT) {
+         read_data_prefixed(l, n);
+      } else if (h.type == CMMFile_DTXT) {
+         read_data_dictionary(l, n);
+      } else {
+         assert(h.type == CMMFile_TEXT);
+         read_data(l, n);
+      }
+   }
+
+   inline void write_data(const string_list& l) {
+      if (l.arena.size() > 0) std::fstream::write(&l.arena[0], l.arena.size());
+   }
+
+   inline void write(const string_list& l) {
+      write_type(CMMFile_TEXT);
+      write_dim(CMMFile_SIZETYPE(l.size()));
+      write_data(l);
+   }
+
+
+public:
+/****************************************************************************************
+   length prefixed text
+      type CMMFile_PTXT, data: 
+         total length of the strings, offsets of the n strings (CMMFile_OFFSETTYPE),
+         n null terminated strings
+      skipping and sizing need no scan through the strings, -1 sizes are
+      determined from the remaining file length
+*****************************************************************************************/
+
+   inline void write_data_prefixed(const std::vector<std::string>& v) {
+      std::vector<CMMFile_OFFSETTYPE> head(v.size() + 1);
+      CMMFile_OFFSETTYPE n = 0;
+      for (size_t i = 0; i < v.size(); i++) {
+         head[i+1] = n;
+         n += v[i].size() + 1;
+      }
+      head[0] = n;
+
+      std::string blob;
+      blob.reserve(n);
+      for (std::vector<std::string>::const_iterator it = v.begin(); it != v.end(); it++) {
+         blob.append(it->c_str(), it->size() + 1);
+      }
+      std::fstream::write((char *) &head[0], head.size() * sizeof(CMMFile_OFFSETTYPE));
+      std::fstream::write(blob.data(), blob.size());
+   }
+
+   inline void write_data_prefixed(const std::vector< std::vector<std::string> >& v) {
+      std::vector<std::string> flat;
+      for (std::vector< std::vector<std::string> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(v[0].size() == it->size());
+         flat.insert(flat.end(), it->begin(), it->end());
+      }
+      write_data_prefixed(flat);
+   }
+
+   inline void write_prefixed(const std::string& v) {
+      write_type(CMMFile_PTXT);
+      write_dim();
+      write_data_prefixed(std::vector<std::string>(1, v));
+   }
+
+   inline void write_prefixed(const std::vector<std::string>& v) {
+      write_type(CMMFile_PTXT);
+      write_dim(v.size());
+      write_data_prefixed(v);
+   }
+
+   inline void write_prefixed(const std::vector< std::vector<std::string> >& v) {
+      write_type(CMMFile_PTXT);
+      write_dim(v.size(), v.empty() ? 0 : v[0].size());
+      write_data_prefixed(v);
+   }
+
+   // read size strings, size = -1 reads until end of file
+   inline void read_data_prefixed(std::vector<std::string>& v, const CMMFile_SIZETYPE& size) {
+      assert(size >= -1);
+      CMMFile_OFFSETTYPE n;
+      read_data(n);
+      CMMFile_SIZETYPE s = size;
+      if (s < 0) {
+         CMMFile_SIZETYPE r;
+         tell_size<char>(r);
+         s = CMMFile_SIZETYPE((r - n) / sizeof(CMMFile_OFFSETTYPE));
+      }
+
+      std::vector<CMMFile_OFFSETTYPE> off;
+      read_data(off, s);
+      std::vector<char> blob;
+      read_data(blob, CMMFile_SIZETYPE(n));
+
+      v.resize(s);
+      for (CMMFile_SIZETYPE i = 0; i < s; i++) {
+         CMMFile_OFFSETTYPE e = (i + 1 < s) ? off[i+1] : n;
+         v[i].assign(&blob[off[i]], e - off[i] - 1);
+      }
+   }
+
+   inline void read_data_prefixed(std::vector< std::vector<std::string> >& v, const CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
+      std::vector<std::string> flat;
+      read_data_prefixed(flat, size1 < 0 ? -1 : size1 * size2);
+      v.resize(size2 > 0 ? flat.size() / size2 : 0);
+      for (size_t i = 0; i < v.size(); i++) {
+         v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+      }
+   }
+
+   inline void skip_prefixed_data(CMMFile_SIZETYPE n) {
+      CMMFile_OFFSETTYPE b;
+      read_data(b);
+      seekg(n * sizeof(CMMFile_OFFSETTYPE) + b, std::ios_base::cur);
+   }
+
+
+public:
+/****************************************************************************************
+   dictionary coded text
+      type CMMFile_DTXT, data:
+         number of distinct strings (CMMFile_OFFSETTYPE), the distinct strings as
+         length prefixed text, for each value the index of its string (CMMFile_SIZETYPE)
+      read_dictionary gives the codes and the dictionary without creating strings,
+      >> expands the entry to strings
+*****************************************************************************************/
+
+   inline void write_data_dictionary(const std::vector<std::string>& v) {
+      std::map<std::string, CMMFile_SIZETYPE> codes;
+      std::vector<std::string> dict;
+      std::vector<CMMFile_SIZETYPE> c(v.size());
+      for (size_t i = 0; i < v.size(); i++) {
+         std::map<std::string, CMMFile_SIZETYPE>::iterator it = codes.find(v[i]);
+         if (it == codes.end()) {
+            it = codes.insert(std::make_pair(v[i], CMMFile_SIZETYPE(dict.size()))).first;
+            dict.push_back(v[i]);
+         }
+         c[i] = it->second;
+      }
+      CMMFile_OFFSETTYPE m = dict.size();
+      std::fstream::write((char *) &m, sizeof(CMMFile_OFFSETTYPE));
+      write_data_prefixed(dict);
+      write_data(c);
+   }
+
+   inline void write_data_dictionary(const std::vector< std::vector<std::string> >& v) {
+      std::vector<std::string> flat;
+      for (std::vector< std::vector<std::string> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(v[0].size() == it->size());
+         flat.insert(flat.end(), it->begin(), it->end());
+      }
+      write_data_dictionary(flat);
+   }
+
+   inline void write_dictionary(const std::vector<std::string>& v) {
+      write_type(CMMFile_DTXT);
+      write_dim(v.size());
+      write_data_dictionary(v);
+   }
+
+   inline void write_dictionary(const std::vector< std::vector<std::string> >& v) {
+      write_type(CMMFile_DTXT);
+      write_dim(v.size(), v.empty() ? 0 : v[0].size());
+      write_data_dictionary(v);
+   }
+
+   // size codes, size = -1 reads until end of file
+   inline void read_data_dictionary(std::vector<CMMFile_SIZETYPE>& codes, string_list& dict, const CMMFile_SIZETYPE& size) {
+      assert(size >= -1);
+      CMMFile_OFFSETTYPE m;
+      std::fstream::read((char *) &m, sizeof(CMMFile_OFFSETTYPE));
+      read_data_prefixed(dict, CMMFile_SIZETYPE(m));
+      read_data(codes, size);
+   }
+
+   // codes of the flattened next entry and its dictionary
+   inline void read_dictionary(std::vector<CMMFile_SIZETYPE>& codes, string_list& dict) {
+      header h;
+      read_header(h);
+      assert(h.type == CMMFile_DTXT);
+      CMMFile_SIZETYPE n = length(h.dim);
+      if (h.dim.size() > 0 && h.dim[0] == -1) n = -1;
+      read_data_dictionary(codes, dict, n);
+   }
+
+   inline void read_data_dictionary(std::vector<std::string>& v, const CMMFile_SIZETYPE& size) {
+      std::vector<CMMFile_SIZETYPE> codes;
+      string_list dict;
+      read_data_dictionary(codes, dict, size);
+      v.resize(codes.size());
+      for (size_t i = 0; i < codes.size(); i++) {
+         assert(codes[i] >= 0 && size_t(codes[i]) < dict.size());
+         v[i].assign(dict[codes[i]], dict.length(codes[i]));
+      }
+   }
+
+   inline void read_data_dictionary(std::vector< std::vector<std::string> >& v, const CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
+      std::vector<std::string> flat;
+      read_data_dictionary(flat, size1 < 0 ? -1 : size1 * size2);
+      v.resize(size2 > 0 ? flat.size() / size2 : 0);
+      for (size_t i = 0; i < v.size(); i++) {
+         v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+      }
+   }
+
+   inline void read_data_dictionary(string_list& l, const CMMFile_SIZETYPE& size) {
+      std::vector<CMMFile_SIZETYPE> codes;
+      string_list dict;
+      read_data_dictionary(codes, dict, size);
+      l.clear();
+      for (size_t i = 0; i < codes.size(); i++) {
+         assert(codes[i] >= 0 && size_t(codes[i]) < dict.size());
+         const char* s = dict[codes[i]];
+         l.arena.insert(l.arena.end(), s, s + dict.length(codes[i]) + 1);
+         l.offsets.push_back(l.arena.size());
+      }
+   }
+
+   inline void skip_dictionary_data(CMMFile_SIZETYPE n) {
+      CMMFile_OFFSETTYPE m;
+      std::fstream::read((char *) &m, sizeof(CMMFile_OFFSETTYPE));
+      skip_prefixed_data(CMMFile_SIZETYPE(m));
+      seekg(n * sizeof(CMMFile_SIZETYPE), std::ios_base::cur);
+   }
+
+
+public:
+/****************************************************************************************
+   bit packed booleans
+      type CMMFile_BITS, data: ceil(n/8) bytes, value i is bit i%8 of byte i/8,
+      arrays are packed as one flat list, a -1 stream ends with a stop bit: a set bit
+      after the last value, write the last part with write_data_bits(v, true)
+      't'/'f' data of CMMFile_BOOL is converted in blocks, 16 values at a time with SSE2
+*****************************************************************************************/
+
+   // bits[i/8] bit i%8 is set if c[i] == 't'
+   static void pack_bools(const char* c, size_t n, unsigned char* bits) {
+      size_t i = 0;
+#ifdef __SSE2__
+      const __m128i t = _mm_set1_epi8(CMMFile_TRUE);
+      for (; i + 16 <= n; i += 16) {
+         int m = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) (c + i)), t));
+         bits[i/8]     = (unsigned char) (m & 0xff);
+         bits[i/8 + 1] = (unsigned char) (m >> 8);
+      }
+#endif
+      for (size_t k = i/8; k < (n + 7)/8; k++) bits[k] = 0;
+      for (; i < n; i++) {
+         if (c[i] == CMMFile_TRUE) bits[i/8] |= (unsigned char) (1 << (i%8));
+      }
+   }
+
+   // c[i] = 't' if bit i%8 of bits[i/8] is set, 'f' otherwise
+   static void unpack_bools(const unsigned char* bits, size_t n, char* c) {
+      size_t i = 0;
+#ifdef __SSE2__
+      const __m128i sel = _mm_set1_epi64x(0x8040201008040201LL);
+      const __m128i f = _mm_set1_epi8(CMMFile_FALSE);
+      const __m128i d = _mm_set1_epi8(CMMFile_TRUE - CMMFile_FALSE);
+      for (; i + 16 <= n; i += 16) {
+         __m128i b = _mm_set_epi64x((long long) (0x0101010101010101ULL * bits[i/8 + 1]),
+                                    (long long) (0x0101010101010101ULL * bits[i/8]));
+         __m128i m = _mm_cmpeq_epi8(_mm_and_si128(b, sel), sel);
+         _mm_storeu_si128((__m128i*) (c + i), _mm_add_epi8(f, _mm_and_si128(m, d)));
+      }
+#endif
+      for (; i < n; i++) {
+         c[i] = (bits[i/8] >> (i%8)) & 1 ? CMMFile_TRUE : CMMFile_FALSE;
+      }
+   }
+
+   static void pack_bools(std::vector<bool>::const_iterator it, size_t n, unsigned char* bits) {
+      size_t k = 0;
+#if defined(CMMFile_BITWORDS) && defined(__GLIBCXX__)   // iterator internals of libstdc++
+      if (it._M_offset % 8 == 0) {
+         k = n/8;
+         memcpy(bits, (const unsigned char*) it._M_p + it._M_offset/8, k);
+         it += k * 8;
+      }
+#endif
+      for (; k < n/8; k++) {
+         unsigned char b = 0;
+         for (int j = 0; j < 8; j++, it++) b |= (unsigned char) (*it << j);
+         bits[k] = b;
+      }
+      if (n%8) {
+         unsigned char b = 0;
+         for (size_t j = 0; j < n%8; j++, it++) b |= (unsigned char) (*it << j);
+         bits[n/8] = b;
+      }
+   }
+
+   static void unpack_bools(const unsigned char* bits, size_t n, std::vector<bool>::iterator it) {
+      size_t i = 0;
+#if defined(CMMFile_BITWORDS) && defined(__GLIBCXX__)
+      if (it._M_offset % 8 == 0) {
+         memcpy((unsigned char*) it._M_p + it._M_offset/8, bits, n/8);
+         i = n/8 * 8;
+         it += i;
+      }
+#endif
+      for (; i < n; i++, it++) {
+         *it = (bits[i/8] >> (i%8)) & 1;
+      }
+   }
+
+   inline void write_data_bits(const bool& v) {
+      unsigned char b = v ? 1 : 0;
+      std::fstream::write((char *) &b, 1);
+   }
+
+   // stop = true writes the last part of a -1 stream, earlier parts need a multiple of 8 values
+   inline void write_data_bits(const std::vector<bool>& v, bool stop = false) {
+      std::vector<unsigned char> bits((v.size() + (stop ? 8 : 7))/8);
+      if (bits.size() == 0) return;
+      pack_bools(v.begin(), v.size(), &bits[0]);
+      if (stop) bits[v.size()/8] |= (unsigned char) (1 << (v.size()%8));
+      std::fstream::write((char *) &bits[0], bits.size());
+   }
+
+   inline void write_data_bits(const std::vector< std::vector<bool> >& v) {
+      size_t size2 = v.empty() ? 0 : v[0].size();
+      std::vector<bool> flat;
+      flat.reserve(v.size() * size2);
+      for (std::vector< std::vector<bool> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(size2 == it->size());
+         flat.insert(flat.end(), it->begin(), it->end());
+      }
+      write_data_bits(flat);
+   }
+
+   inline void write_bits(const bool& v) {
+      write_type(CMMFile_BITS);
+      write_dim();
+      write_data_bits(v);
+   }
+
+   inline void write_bits(const std::vector<bool>& v) {
+      write_type(CMMFile_BITS);
+      write_dim(v.size());
+      write_data_bits(v);
+   }
+
+   inline void write_bits(const std::vector< std::vector<bool> >& v) {
+      write_type(CMMFile_BITS);
+      write_dim(v.size(), v.empty() ? 0 : v[0].size());
+      write_data_bits(v);
+   }
+
+   inline void read_data_bits(bool& v) {
+      unsigned char b;
+      std::fstream::read((char *) &b, 1);
+      v = b & 1;
+   }
+
+   // read size values, size = -1 reads until end of file
+   inline void read_data_bits(std::vector<bool>& v, const CMMFile_SIZETYPE& size) {
+      assert(size >= -1);
+      CMMFile_SIZETYPE s = size;
+      std::vector<unsigned char> bits;
+      if (s < 0) {
+         read_data(bits, -1);
+         s = 8 * bits.size();
+         // drop the stop bit and the padding after it
+         if (s > 0 && bits.back() != 0) {
+            int k = 7;
+            while (!((bits.back() >> k) & 1)) k--;
+            s -= 8 - k;
+         }
+      } else {
+         read_data(bits, (s + 7)/8);
+      }
+      v.resize(s);
+      if (s > 0) unpack_bools(&bits[0], s, v.begin());
+   }
+
+   inline void read_data_bits(std::vector< std::vector<bool> >& v, const CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
+      std::vector<bool> flat;
+      read_data_bits(flat, size1 < 0 ? -1 : size1 * size2);
+      v.resize(size2 > 0 ? flat.size() / size2 : 0);
+      for (size_t i = 0; i < v.size(); i++) {
+         v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+      }
+   }
+
+   inline void skip_bits_data(CMMFile_SIZETYPE n) {
+      seekg((n + 7)/8, std::ios_base::cur);
+   }
+
+
+public:
+/****************************************************************************************
+   compressed entries
+      type CMMFile_ZIPD for fixed size types, data:
+         type of the values (char), number of values, values per chunk (CMMFile_OFFSETTYPE),
+         offsets of the chunks and end of last chunk relative to the first one (CMMFile_OFFSETTYPE),
+         chunks: 0 + raw bytes or 1 + lz compressed bytes of the byte shuffled values
+      chunks are (de)compressed by several threads, read_range only decompresses the
+      chunks it needs, -1 dimensions are not supported
+*****************************************************************************************/
+
+   // chunk size in bytes and threads used for compression / decompression, 0 = all cores
+   void set_compression(size_t chunk_size, int threads = 0) {
+      compression_chunk = chunk_size > 0 ? chunk_size : 1;
+      compression_threads = threads;
+   }
+
+   template<typename V>
+   inline void write_data_compressed(const V* v, CMMFile_OFFSETTYPE n) {
+      CMMFile_STATIC_ASSERT(CMMFile_numeric<V>::value, "only numbers are compressed");
+      assert(n >= 0);
+      CMMFile_OFFSETTYPE per = std::max<CMMFile_OFFSETTYPE>(1, compression_chunk / sizeof(V));
+      CMMFile_OFFSETTYPE nc = (n + per - 1) / per;
+
+      std::vector< std::vector<unsigned char> > chunks(nc);
+      compress_task t = { (const unsigned char*) v, size_t(n) * sizeof(V), sizeof(V), size_t(per) * sizeof(V), &chunks };
+      run_parallel(nc, t);
+
+      std::vector<CMMFile_OFFSETTYPE> head(3 + nc);
+      head[0] = n;
+      head[1] = per;
+      head[2] = 0;
+      for (CMMFile_OFFSETTYPE k = 0; k < nc; k++) head[3 + k] = head[2 + k] + chunks[k].size();
+      write_type(to_type<V>());
+      std::fstream::write((char *) &head[0], head.size() * sizeof(CMMFile_OFFSETTYPE));
+      for (CMMFile_OFFSETTYPE k = 0; k < nc; k++) {
+         std::fstream::write((char *) &chunks[k][0], chunks[k].size());
+      }
+   }
+
+   template<typename V>
+   inline void write_data_compressed(const std::vector<V>& v) {
+      write_data_compressed(v.empty() ? (const V*) 0 : &v[0], v.size());
+   }
+
+   template<typename V>
+   inline void write_data_compressed(const std::vector< std::vector<V> >& v) {
+      std::vector<V> flat;
+      if (!v.empty()) flat.reserve(v.size() * v[0].size());
+      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(v[0].size() == it->size());
+         flat.insert(flat.end(), it->begin(), it->end());
+      }
+      write_data_compressed(flat);
+   }
+
+   template<typename V>
+   inline void write_compressed(const std::vector<V>& v) {
+      write_type(CMMFile_ZIPD);
+      write_dim(v.size());
+      write_data_compressed(v);
+   }
+
+   template<typename V>
+   inline void write_compressed(const std::vector< std::vector<V> >& v) {
+      write_type(CMMFile_ZIPD);
+      write_dim(v.size(), v.empty() ? 0 : v[0].size());
+      write_data_compressed(v);
+   }
+
+   // read values first ... first + count - 1, the stream is positioned at the end of the data
+   template<typename V>
+   inline void read_data_compressed(V* v, CMMFile_OFFSETTYPE first, CMMFile_OFFSETTYPE count) {
+      CMMFile_TYPETYPE t = read_type();
+      assert(is_type<V>(t));
+      CMMFile_OFFSETTYPE head[3];
+      std::fstream::read((char *) head, sizeof(head));
+      CMMFile_OFFSETTYPE n = head[0], per = head[1];
+      CMMFile_OFFSETTYPE nc = (n + per - 1) / per;
+      assert(first >= 0 && count >= 0 && first + count <= n);
+      std::vector<CMMFile_OFFSETTYPE> off(nc + 1);
+      off[0] = head[2];
+      if (nc > 0) std::fstream::read((char *) &off[1], nc * sizeof(CMMFile_OFFSETTYPE));
+      std::streamoff start = tellg();
+
+      if (count > 0) {
+         CMMFile_OFFSETTYPE k0 = first / per, k1 = (first + count - 1) / per;
+         std::vector<unsigned char> data(off[k1 + 1] - off[k0]);
+         seekg(off[k0], std::ios_base::cur);
+         std::fstream::read((char *) &data[0], data.size());
+
+         std::vector<char> ok(k1 - k0 + 1, 1);
+         decompress_task d = { &data[0], &off[0], sizeof(V), size_t(per) * sizeof(V), size_t(n) * sizeof(V),
+                               (unsigned char*) v, size_t(first) * sizeof(V), size_t(count) * sizeof(V), k0, &ok[0] };
+         run_parallel(ok.size(), d);
+         bool good = std::find(ok.begin(), ok.end(), 0) == ok.end();
+         assert(good);
+         if (!good) setstate(std::ios::failbit);
+      }
+      seekg(start + std::streamoff(off[nc]), std::ios_base::beg);
+   }
+
+   template<typename V, typename S>
+   inline void read_data_compressed(std::vector<V>& v, const S& size) {
+      assert(size >= 0);
+      v.resize(size);
+      read_data_compressed(v.empty() ? (V*) 0 : &v[0], 0, size);
+   }
+
+   template<typename V, typename S>
+   inline void read_data_compressed(std::vector< std::vector<V> >& v, const S& size1, const S& size2) {
+      std::vector<V> flat;
+      read_data_compressed(flat, size1 * size2);
+      v.resize(size1);
+      for (S i = 0; i < size1; i++) {
+         v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+      }
+   }
+
+   // read values first ... first + count - 1 of the flattened next entry
+   template<typename V>
+   inline void read_range(std::vector<V>& v, CMMFile_OFFSETTYPE first, CMMFile_OFFSETTYPE count) {
+      header h;
+      read_header(h);
+      CMMFile_OFFSETTYPE n = length(h.dim);
+      assert(h.dim.size() == 0 || h.dim[0] >= 0);
+      v.resize(count);
+      if (h.type == CMMFile_ZIPD) {
+         read_data_compressed(v.empty() ? (V*) 0 : &v[0], first, count);
+         return;
+      }
+      assert(is_type<V>(h.type));
+      assert(first >= 0 && count >= 0 && first + count <= n);
+      seekg(first * sizeof(V), std::ios_base::cur);
+      if (count > 0) std::fstream::read((char *) &v[0], count * sizeof(V));
+      seekg((n - first - count) * sizeof(V), std::ios_base::cur);
+   }
+
+   inline void skip_compressed_data() {
+      read_type();
+      CMMFile_OFFSETTYPE head[3];
+      std::fstream::read((char *) head, sizeof(head));
+      CMMFile_OFFSETTYPE nc = (head[0] + head[1] - 1) / head[1];
+      CMMFile_OFFSETTYPE end = head[2];
+      if (nc > 0) {
+         seekg((nc - 1) * sizeof(CMMFile_OFFSETTYPE), std::ios_base::cur);
+         std::fstream::read((char *) &end, sizeof(end));
+      }
+      seekg(end, std::ios_base::cur);
+   }
+
+   // lz compression of n bytes into out (at least n + n/255 + 16 bytes), returns compressed size
+   static size_t lz_compress(const unsigned char* in, size_t n, unsigned char* out) {
+      const int bits = 14;
+      std::vector<unsigned int> table(1 << bits, 0);
+      size_t ip = 0, anchor = 0, op = 0;
+      if (n >= 16) {
+         const size_t limit = n - 12;
+         while (ip < limit) {
+            unsigned int seq;
+            memcpy(&seq, in + ip, 4);
+            unsigned int h = (seq * 2654435761u) >> (32 - bits);
+            size_t ref = table[h];
+            table[h] = (unsigned int) ip;
+            unsigned int r;
+            memcpy(&r, in + ref, 4);
+            if (ref >= ip || ip - ref > 0xffff || r != seq) {
+               ip += 1 + ((ip - anchor) >> 6);
+               continue;
+            }
+            size_t len = 4;
+            while (ip + len < n - 5 && in[ref + len] == in[ip + len]) len++;
+            op = lz_sequence(in + anchor, ip - anchor, ip - ref, len, out, op);
+            ip += len;
+            anchor = ip;
+         }
+      }
+      return lz_sequence(in + anchor, n - anchor, 0, 0, out, op);
+   }
+
+   // returns false for corrupt data
+   static bool lz_decompress(const unsigned char* in, size_t n, unsigned char* out, size_t m) {
+      size_t ip = 0, op = 0;
+      while (ip < n) {
+         unsigned char token = in[ip++];
+         size_t lit = token >> 4;
+         if (lit == 15 && !lz_length(in, n, ip, lit)) return false;
+         if (lit > n - ip || lit > m - op) return false;
+         if (lit > 0) memcpy(out + op, in + ip, lit);
+         ip += lit; op += lit;
+         if (ip == n) break;
+
+         if (n - ip < 2) return false;
+         size_t off = in[ip] | (in[ip + 1] << 8);
+         ip += 2;
+         size_t len = token & 15;
+         if (len == 15 && !lz_length(in, n, ip, len)) return false;
+         len += 4;
+         if (off == 0 || off > op || len > m - op) return false;
+         // overlapping matches repeat the last off bytes
+         for (size_t i = 0; i < len; i += off) {
+            memcpy(out + op + i, out + op + i - off, std::min(off, len - i));
+         }
+         op += len;
+      }
+      return op == m;
+   }
+
+private:
+   size_t compression_chunk;
+   int compression_threads;
+
+   // token, literals and for len > 0 offset and match
+   static size_t lz_sequence(const unsigned char* lit, size_t nl, size_t off, size_t len, unsigned char* out, size_t op) {
+      size_t tok = op++;
+      size_t ml = len > 0 ? len - 4 : 0;
+      out[tok] = (unsigned char) ((std::min<size_t>(nl, 15) << 4) | std::min<size_t>(ml, 15));
+      if (nl >= 15) {
+         size_t r = nl - 15;
+         for (; r >= 255; r -= 255) out[op++] = 255;
+         out[op++] = (unsigned char) r;
+      }
+      if (nl > 0) memcpy(out + op, lit, nl);
+      op += nl;
+      if (len > 0) {
+         out[op++] = (unsigned char) (off & 0xff);
+         out[op++] = (unsigned char) (off >> 8);
+         if (ml >= 15) {
+            size_t r = ml - 15;
+            for (; r >= 255; r -= 255) out[op++] = 255;
+            out[op++] = (unsigned char) r;
+         }
+      }
+      return op;
+   }
+
+   static bool lz_length(const unsigned char* in, size_t n, size_t& ip, size_t& len) {
+      unsigned char b;
+      do {
+         if (ip >= n) return false;
+         b = in[ip++];
+         len += b;
+      } while (b == 255);
+      return true;
+   }
+
+   // bytes of the values grouped by significance, bytes of a partial value are kept
+   static void shuffle(const unsigned char* in, size_t n, size_t es, unsigned char* out) {
+      size_t m = n / es;
+      for (size_t i = 0; i < m; i++) {
+         for (size_t b = 0; b < es; b++) out[b * m + i] = in[i * es + b];
+      }
+      memcpy(out + m * es, in + m * es, n - m * es);
+   }
+
+   static void unshuffle(const unsigned char* in, size_t n, size_t es, unsigned char* out) {
+      size_t m = n / es;
+      for (size_t i = 0; i < m; i++) {
+         for (size_t b = 0; b < es; b++) out[i * es + b] = in[b * m + i];
+      }
+      memcpy(out + m * es, in + m * es, n - m * es);
+   }
+
+   struct compress_task {
+      const unsigned char* data;
+      size_t size, es, chunk;
+      std::vector< std::vector<unsigned char> >* chunks;
+
+      void operator()(size_t k) {
+         size_t n = std::min(chunk, size - k * chunk);
+         std::vector<unsigned char> s(n);
+         if (n > 0) shuffle(data + k * chunk, n, es, &s[0]);
+         std::vector<unsigned char>& c = (*chunks)[k];
+         c.resize(1 + n + n / 255 + 16);
+         size_t m = lz_compress(s.empty() ? 0 : &s[0], n, &c[1]);
+         if (m < n) {
+            c[0] = 1;
+            c.resize(1 + m);
+         } else {
+            c[0] = 0;
+            memcpy(&c[1], data + k * chunk, n);
+            c.resize(1 + n);
+         }
+      }
+   };
+
+   struct decompress_task {
+      const unsigned char* data;        // chunks k0, ...
+      const CMMFile_OFFSETTYPE* off;
+      size_t es, chunk, size;
+      unsigned char* out;               // bytes first ... first + count - 1
+      size_t first, count;
+      CMMFile_OFFSETTYPE k0;
+      char* ok;                         // per chunk, set to 0 for a damaged chunk
+
+      void operator()(size_t i) {
+         size_t k = k0 + i;
+         const unsigned char* c = data + (off[k] - off[k0]);
+         size_t nc = off[k + 1] - off[k];
+         size_t b = k * chunk;
+         size_t n = std::min(chunk, size - b);
+         size_t lo = std::max(b, first), hi = std::min(b + n, first + count);
+
+         // chunks inside the range are decoded in place
+         std::vector<unsigned char> raw, s;
+         unsigned char* r = out + (lo - first);
+         if (lo != b || hi != b + n) {
+            raw.resize(n);
+            r = n > 0 ? &raw[0] : 0;
+         }
+         bool good = nc >= 1;
+         if (good && c[0] == 1) {
+            s.resize(n);
+            good = lz_decompress(c + 1, nc - 1, n > 0 ? &s[0] : 0, n);
+            if (good && n > 0) unshuffle(&s[0], n, es, r);
+         } else {
+            good = good && c[0] == 0 && nc - 1 == n;
+            if (good && n > 0) memcpy(r, c + 1, n);
+         }
+         if (!good) { ok[i] = 0; return; }
+         if (!raw.empty() && hi > lo) memcpy(out + (lo - first), &raw[lo - b], hi - lo);
+      }
+   };
+
+   // calls t(k) for k = 0 ... n - 1 using compression_threads threads
+   template<typename T>
+   void run_parallel(size_t n, T& t) {
+#ifdef CMMFile_THREADS
+      int threads = compression_threads > 0 ? compression_threads : std::thread::hardware_concurrency();
+      if (size_t(threads) > n) threads = n;
+      if (threads > 1) {
+         std::mutex mutex;
+         size_t next = 0;
+         std::vector<std::thread> pool;
+         for (int i = 0; i < threads; i++) {
+            pool.push_back(std::thread(&CMMFile::run_tasks<T>, &t, n, &mutex, &next));
+         }
+         for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+         return;
+      }
+#endif
+      for (size_t k = 0; k < n; k++) t(k);
+   }
+
+#ifdef CMMFile_THREADS
+   template<typename T>
+   static void run_tasks(T* t, size_t n, std::mutex* mutex, size_t* next) {
+      while (true) {
+         size_t k;
+         {
+            std::lock_guard<std::mutex> lock(*mutex);
+            if (*next >= n) return;
+            k = (*next)++;
+         }
+         (*t)(k);
+      }
+   }
+#endif
+
+
+public:
+/****************************************************************************************
+   delta varint coded integers
+      type CMMFile_VINT for integer vectors and arrays, data:
+         number of bytes (CMMFile_OFFSETTYPE), for each value the difference to the
+         previous one zigzag and LEB128 coded (7 bits per byte, high bit: more bytes follow)
+      sorted lists of small values need about one byte per value,
+      in sequences -1 columns store the number of values before the data as usual
+*****************************************************************************************/
+
+   template<typename V>
+   inline void write_data_varint(const V* v, size_t n) {
+      CMMFile_STATIC_ASSERT(CMMFile_integer<V>::value, "only integers are varint coded");
+      std::vector<unsigned char> d;
+      encode_varints(v, n, d);
+      CMMFile_OFFSETTYPE nb = d.size();
+      std::fstream::write((char *) &nb, sizeof(CMMFile_OFFSETTYPE));
+      if (nb > 0) std::fstream::write((char *) &d[0], nb);
+   }
+
+   template<typename V>
+   inline void write_data_varint(const std::vector<V>& v) {
+      write_data_varint(v.empty() ? (const V*) 0 : &v[0], v.size());
+   }
+
+   template<typename V>
+   inline void write_data_varint(const std::vector< std::vector<V> >& v) {
+      std::vector<V> flat;
+      if (!v.empty()) flat.reserve(v.size() * v[0].size());
+      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(v[0].size() == it->size());
+         flat.insert(flat.end(), it->begin(), it->end());
+      }
+      write_data_varint(flat);
+   }
+
+   // varint coded sequence columns hold integers, other types of a column are a type mismatch
+   template<typename T>
+   inline void write_data_varint(const T& v, CMMFile_tag<true>) { write_data_varint(v); }
+
+   template<typename T>
+   inline void write_data_varint(const T&, CMMFile_tag<false>) {
+      assert(!"varint coded column needs integers");
+      setstate(std::ios::failbit);
+   }
+
+   template<typename V>
+   inline void write_varint(const std::vector<V>& v) {
+      write_type(CMMFile_VINT);
+      write_dim(v.size());
+      write_data_varint(v);
+   }
+
+   template<typename V>
+   inline void write_varint(const std::vector< std::vector<V> >& v) {
+      write_type(CMMFile_VINT);
+      write_dim(v.size(), v.empty() ? 0 : v[0].size());
+      write_data_varint(v);
+   }
+
+   // read size values, -1 reads all values of the data
+   template<typename V, typename S>
+   inline void read_data_varint(std::vector<V>& v, const S& size) {
+      assert(size >= -1);
+      CMMFile_OFFSETTYPE nb;
+      std::fstream::read((char *) &nb, sizeof(CMMFile_OFFSETTYPE));
+      std::vector<unsigned char> d(nb);
+      if (nb > 0) std::fstream::read((char *) &d[0], nb);
+      const unsigned char* p = nb > 0 ? &d[0] : 0;
+
+      size_t n = size;
+      if (size < 0) {
+         n = 0;
+         for (CMMFile_OFFSETTYPE k = 0; k < nb; k++) n += p[k] < 0x80;
+      }
+      v.resize(n);
+      size_t r = decode_varints(p, nb, n > 0 ? &v[0] : (V*) 0, n);
+      assert(r == n);
+      if (r != n) setstate(std::ios::failbit);
+   }
+
+   template<typename V, typename S>
+   inline void read_data_varint(std::vector< std::vector<V> >& v, const S& size1, const S& size2) {
+      std::vector<V> flat;
+      read_data_varint(flat, size1 < 0 ? -1 : size1 * size2);
+      v.resize(size2 > 0 ? flat.size() / size2 : 0);
+      for (size_t i = 0; i < v.size(); i++) {
+         v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+      }
+   }
+
+   inline void skip_varint_data() {
+      CMMFile_OFFSETTYPE nb;
+      std::fstream::read((char *) &nb, sizeof(CMMFile_OFFSETTYPE));
+      seekg(nb, std::ios_base::cur);
+   }
+
+   template<typename V>
+   static void encode_varints(const V* v, size_t n, std::vector<unsigned char>& d) {
+      d.resize(10 * n);
+      size_t k = 0;
+      unsigned long long prev = 0;
+      for (size_t i = 0; i < n; i++) {
+         unsigned long long u = (unsigned long long) (long long) v[i];
+         unsigned long long x = u - prev;
+         unsigned long long z = (x << 1) ^ (0 - (x >> 63));
+         prev = u;
+         while (z >= 0x80) {
+            d[k++] = (unsigned char) (z | 0x80);
+            z >>= 7;
+         }
+         d[k++] = (unsigned char) z;
+      }
+      d.resize(k);
+   }
+
+   // decodes at most n values, returns number of values decoded,
+   // runs of 8 one byte values are decoded from a single word
+   template<typename V>
+   static size_t decode_varints(const unsigned char* p, size_t nb, V* v, size_t n) {
+      size_t i = 0, k = 0;
+      unsigned long long prev = 0;
+      while (k < nb && i < n) {
+         if (k + 8 <= nb && i + 8 <= n) {
+            unsigned long long w;
+            memcpy(&w, p + k, 8);
+            if (!(w & 0x8080808080808080ULL)) {
+               for (int j = 0; j < 8; j++, w >>= 8) {
+                  unsigned long long z = w & 0xff;
+                  prev += (z >> 1) ^ (0 - (z & 1));
+                  v[i++] = V((long long) prev);
+               }
+               k += 8;
+               continue;
+            }
+         }
+         unsigned long long z = 0;
+         int shift = 0;
+         unsigned char b;
+         do {
+            b = p[k++];
+            if (shift < 64) z |= (unsigned long long) (b & 0x7f) << shift;
+            shift += 7;
+         } while ((b & 0x80) && k < nb);
+         if (b & 0x80) break;   // truncated
+         prev += (z >> 1) ^ (0 - (z & 1));
+         v[i++] = V((long long) prev);
+      }
+      return i;
+   }
+
+
+public:
+/****************************************************************************************
+   reading into caller memory
+      read_into reads the next entry into v of the given capacity and returns the number
+      of values read, -1 streams are read in pieces of at most capacity values,
+      vectors with other allocators (e.g. CMMFile_default_init_allocator or std::pmr)
+      are read in place, sequences construct their records in place in the column vectors
+*****************************************************************************************/
+
+   template<typename V, typename S>
+   inline CMMFile_SIZETYPE read_data_into(V* v, size_t capacity, const S& size) {
+      assert(size >= -1);
+      S s = size;
+      if (s < 0) {
+         tell_size<V>(s);
+         s = std::min<S>(s, S(capacity));
+      }
+      assert(size_t(s) <= capacity);
+      if (s > 0) std::fstream::read((char *) v, s * sizeof(V));
+      return s;
+   }
+
+   template<typename V>
+   inline CMMFile_SIZETYPE read_into(V* v, size_t capacity) {
+      assert(is_type<V>(read_type()));
+      CMMFile_DIMTYPE d = read_dim();
+      assert(d <= 1);
+      return read_data_into(v, capacity, d == 0 ? 1 : read_size());
+   }
+
+   template<typename V, typename A, typename S>
+   inline void read_data(std::vector<V, A>& v, const S& size) {
+      assert(size >= -1);
+      S s = size;
+      if (s < 0) tell_size<V>(s);
+      v.resize(s);
+      if (s > 0) std::fstream::read((char *) &v[0], s * sizeof(V));
+   }
+
+   template<typename V, typename A, typename S>
+   inline void read_data_typed(const CMMFile_TYPETYPE& t, std::vector<V, A>& v, const S& size) {
+      if (is_type<V>(t)) {
+         read_data(v, size);
+         return;
+      }
+      std::vector<V> w;
+      read_data_typed(t, w, size);
+      v.assign(w.begin(), w.end());
+   }
+
+   template<typename V, typename A>
+   inline void read(std::vector<V, A>& v) {
+      CMMFile_TYPETYPE t = read_type();
+      assert(read_dim() == 1);
+      read_data_typed(t, v, read_size());
+   }
+
+   template<typename V, typename A>
+   inline void write(const std::vector<V, A>& v) {
+      write_header<V>(v.size());
+      if (v.size() > 0) std::fstream::write((char *) &v[0], v.size() * sizeof(V));
+   }
+
+   template<typename V, typename A1, typename A2, typename S>
+   inline void read_data(std::vector< std::vector<V, A1>, A2 >& v, const S& size1, const S& size2) {
+      assert(size1 >= -1);
+      S s = size1;
+      if (s < 0) tell_size<V>(s, size2);
+      v.resize(s);
+      for (typename std::vector< std::vector<V, A1>, A2 >::iterator it = v.begin(); it != v.end(); it++) {
+         it->resize(size2);
+         if (size2 > 0) std::fstream::read((char *) &((*it)[0]), size2 * sizeof(V));
+      }
+   }
+
+   template<typename V, typename A1, typename A2, typename S>
+   inline void read_data_typed(const CMMFile_TYPETYPE& t, std::vector< std::vector<V, A1>, A2 >& v, const S& size1, const S& size2) {
+      if (is_type<V>(t)) {
+         read_data(v, size1, size2);
+         return;
+      }
+      std::vector< std::vector<V> > w;
+      read_data_typed(t, w, size1, size2);
+      v.resize(w.size());
+      for (size_t i = 0; i < w.size(); i++) v[i].assign(w[i].begin(), w[i].end());
+   }
+
+   template<typename V, typename A1, typename A2>
+   inline void read(std::vector< std::vector<V, A1>, A2 >& v) {
+      CMMFile_TYPETYPE t = read_type();
+      assert(read_dim() == 2);
+      CMMFile_SIZETYPE size1 = read_size();
+      CMMFile_SIZETYPE size2 = read_size();
+      read_data_typed(t, v, size1, size2);
+   }
+
+   // rows with another allocator in a std::allocator vector, resolves read(std::vector<V>&)
+   template<typename V, typename A1>
+   inline void read(std::vector< std::vector<V, A1> >& v) {
+      read< V, A1, std::allocator< std::vector<V, A1> > >(v);
+   }
+
+#ifdef CMMFile_PMR
+   // monotonic arena for std::pmr containers read from this file, e.g.
+   //    std::pmr::vector<double> v(cmmfile.arena());
+   // memory is only given back by release_arena() or when the CMMFile is destroyed
+   std::pmr::memory_resource* arena() { return &arena_resource; }
+   void release_arena() { arena_resource.release(); }
+
+private:
+   std::pmr::monotonic_buffer_resource arena_resource;
+#endif
+
+
+public:
+/****************************************************************************************
+   matrices
+      2d entries as CMMFile_matrix, the data is moved with a single read / write
+*****************************************************************************************/
+
+   template<typename V>
+   inline void write_data(const CMMFile_matrix<V>& m) {
+      if (m.size() > 0) std::fstream::write((char *) m.data(), m.size() * sizeof(V));
+   }
+
+   template<typename V, typename S>
+   inline void read_data(CMMFile_matrix<V>& m, const S& size1, const S& size2) {
+      assert(size1 >= -1);
+      S s = size1;
+      if (s < 0) tell_size<V>(s, size2);
+      m.resize(s, size2);
+      if (m.size() > 0) std::fstream::read((char *) m.data(), m.size() * sizeof(V));
+   }
+
+   template<typename V, typename S>
+   inline void read_data_typed(const CMMFile_TYPETYPE& t, CMMFile_matrix<V>& m, const S& size1, const S& size2) {
+      if (is_type<V>(t)) {
+         read_data(m, size1, size2);
+         return;
+      }
+      if (t == CMMFile_TILE) {
+         std::vector<CMMFile_SIZETYPE> dim(1, size1), start(2, 0);
+         dim.push_back(size2);
+         m.resize(size1, size2);
+         read_region(m.data(), t, dim, tellg(), start, dim, std::vector<CMMFile_SIZETYPE>());
+         return;
+      }
+      std::vector<V> w;
+      read_data_typed(t, w, size1 < 0 ? S(-1) : S(size1 * size2));
+      m.resize(size2 > 0 ? CMMFile_SIZETYPE(w.size() / size2) : size1, size2);
+      std::copy(w.begin(), w.begin() + m.size(), m.values.begin());
+   }
+
+   template<typename V>
+   inline void write(const CMMFile_matrix<V>& m) {
+      write_header<V>(m.rows, m.cols);
+      write_data(m);
+   }
+
+   template<typename V>
+   inline void read(CMMFile_matrix<V>& m) {
+      CMMFile_TYPETYPE t = read_type();
+      assert(read_dim() == 2);
+      CMMFile_SIZETYPE size1 = read_size();
+      CMMFile_SIZETYPE size2 = read_size();
+      read_data_typed(t, m, size1, size2);
+   }
+
+   template<typename V>
+   inline void write_data_sequence(const CMMFile_matrix<V>& m) {
+      assert((*actual_header).type == to_type<V>());
+      assert((*actual_header).dim.size() == 2);
+
+      if ((*actual_header).dim[0] == -1) {
+         write_size(m.rows);
+      } else {
+         assert((*actual_header).dim[0] == m.rows);
+      }
+      assert((*actual_header).dim[1] == m.cols);
+
+      write_data(m);
+      increase_actual_header();
+   }
+
+   template<typename V>
+   inline void read_data_sequence(CMMFile_matrix<V>& m) {
+      assert((*actual_header).dim.size() == 2);
+      CMMFile_SIZETYPE size1 = (*actual_header).dim[0];
+      CMMFile_SIZETYPE size2 = (*actual_header).dim[1];
+      if (size1 == -1) size1 = read_size();
+      read_data_typed((*actual_header).type, m, size1, size2);
+      increase_actual_header();
+   }
+
+
+public:
+/****************************************************************************************
+   tensors
+      entries of any dimension in one aligned allocation (see CMMFile_tensor),
+      read_tensor reads into caller memory of a given shape checked against the header,
+      -1 first dimensions are determined by tell_size
+*****************************************************************************************/
+
+   template<typename V>
+   inline void write(const CMMFile_tensor<V>& t) {
+      write_header<V>(t.shape);
+      write_data(t.data(), t.size());
+   }
+
+   template<typename V>
+   inline void read(CMMFile_tensor<V>& t) {
+      header h;
+      read_header(h);
+      std::vector<CMMFile_SIZETYPE> s;
+      tensor_shape<V>(h, s);
+      t.resize(s);
+      read_data_tensor(h.type, s, t.data());
+   }
+
+   template<typename V>
+   inline void read_tensor(V* v, const std::vector<CMMFile_SIZETYPE>& shape) {
+      header h;
+      read_header(h);
+      std::vector<CMMFile_SIZETYPE> s;
+      tensor_shape<V>(h, s);
+      assert(s == shape);
+      read_data_tensor(h.type, s, v);
+   }
+
+private:
+   // shape of an entry with header h, resolving a -1 first dimension
+   template<typename V>
+   void tensor_shape(const header& h, std::vector<CMMFile_SIZETYPE>& s) {
+      s = h.dim;
+      if (!s.empty() && s[0] < 0) {
+         assert(is_type<V>(h.type));
+         CMMFile_SIZETYPE rest = 1;
+         for (size_t d = 1; d < s.size(); d++) rest *= s[d];
+         s[0] = 0;
+         if (rest > 0) tell_size<V>(s[0], rest);
+      }
+   }
+
+   template<typename V>
+   void read_data_tensor(CMMFile_TYPETYPE t, const std::vector<CMMFile_SIZETYPE>& s, V* v) {
+      CMMFile_SIZETYPE n = length(s);
+      if (t == CMMFile_TILE) {
+         std::vector<CMMFile_SIZETYPE> start(s.size(), 0);
+         read_region(v, t, s, tellg(), start, s, std::vector<CMMFile_SIZETYPE>());
+      } else if (is_type<V>(t)) {
+         if (n > 0) std::fstream::read((char *) v, n * sizeof(V));
+      } else {
+         std::vector<V> w;
+         read_data_typed(t, w, n);
+         assert(CMMFile_SIZETYPE(w.size()) == n);
+         std::copy(w.begin(), w.end(), v);
+      }
+   }
+
+
+public:
+/****************************************************************************************
+   decimated reading
+      reads nr sub arrays (values of vectors, rows of matrices) and skips ns of them
+      as cmm_read_data.m, only the kept bytes are read: with the posix backend by preadv,
+      gaps below a page read into a scratch buffer, with open_read_mmap from the mapping
+*****************************************************************************************/
+
+   template<typename V, typename S>
+   inline void read_data_skip(std::vector<V>& v, const S& size, CMMFile_SIZETYPE nr, CMMFile_SIZETYPE ns) {
+      assert(size >= -1);
+      S s = size;
+      if (s < 0) tell_size<V>(s);
+      v.resize(kept(s, nr, ns));
+      read_runs(v.empty() ? (char *) 0 : (char *) &v[0], s, sizeof(V), nr, ns);
+   }
+
+   template<typename V, typename S>
+   inline void read_data_skip(std::vector< std::vector<V> >& v, const S& size1, const S& size2,
+                              CMMFile_SIZETYPE nr, CMMFile_SIZETYPE ns) {
+      assert(size1 >= -1);
+      S s = size1;
+      if (s < 0) tell_size<V>(s, size2);
+      std::vector<V> flat(kept(s, nr, ns) * size2);
+      read_runs(flat.empty() ? (char *) 0 : (char *) &flat[0], s, size2 * sizeof(V), nr, ns);
+      v.resize(kept(s, nr, ns));
+      for (CMMFile_SIZETYPE i = 0; i < CMMFile_SIZETYPE(v.size()); i++) {
+         v[i].assign(flat.begin() + i * size2, flat.begin() + (i+1) * size2);
+      }
+   }
+
+   template<typename V>
+   inline void read_skip(std::vector<V>& v, CMMFile_SIZETYPE nr, CMMFile_SIZETYPE ns) {
+      assert(is_type<V>(read_type()));
+      assert(read_dim() == 1);
+      read_data_skip(v, read_size(), nr, ns);
+   }
+
+   template<typename V>
+   inline void read_skip(std::vector< std::vector<V> >& v, CMMFile_SIZETYPE nr, CMMFile_SIZETYPE ns) {
+      assert(is_type<V>(read_type()));
+      assert(read_dim() == 2);
+      CMMFile_SIZETYPE size1 = read_size();
+      CMMFile_SIZETYPE size2 = read_size();
+      read_data_skip(v, size1, size2, nr, ns);
+   }
+
+private:
+   // number of sub arrays of n kept reading nr and skipping ns
+   static CMMFile_SIZETYPE kept(CMMFile_SIZETYPE n, CMMFile_SIZETYPE nr, CMMFile_SIZETYPE ns) {
+      assert(nr > 0 && ns >= 0);
+      return (n / (nr + ns)) * nr + std::min(n % (nr + ns), nr);
+   }
 
-class CMMFile : public std::fstream {
-public:
-   std::string filename;
+   // read the kept ones of n sub arrays of b bytes at the actual position into out
+   void read_runs(char* out, CMMFile_SIZETYPE n, size_t b, CMMFile_SIZETYPE nr, CMMFile_SIZETYPE ns) {
+      if (ns == 0 && n > 0) nr = n;   // runs without gaps are read at once
+      std::streamoff pos = tellg();
+      std::streamoff end = pos + std::streamoff(n * b);
+      size_t run = nr * b, gap = ns * b, period = run + gap;
+      CMMFile_SIZETYPE np = (n + nr + ns - 1) / (nr + ns);
+      size_t last = (n - (np - 1) * (nr + ns) < nr) ? (n - (np - 1) * (nr + ns)) * b : run;
+
+      CMMFile_membuf* m = memory();
+      if (m) {
+         assert(end <= std::streamoff(m->size()));
+         for (CMMFile_SIZETYPE p = 0; p < np; p++) {
+            memcpy(out + p * run, m->data() + pos + p * period, p + 1 < np ? run : last);
+         }
+#ifdef CMMFile_POSIX
+      } else if (io == &posixbuf) {
+         // one preadv per contiguous part of the file, small gaps go to a scratch buffer
+         std::vector<char> scratch(gap > 0 && gap < 4096 ? gap : 0);
+         std::vector<iovec> iov;
+         std::streamoff at = pos;
+         for (CMMFile_SIZETYPE p = 0; p < np; p++) {
+            iovec r = { out + p * run, p + 1 < np ? run : last };
+            iov.push_back(r);
+            bool joined = !scratch.empty() && p + 1 < np && iov.size() + 2 <= 1024;
+            if (joined) {
+               iovec g = { &scratch[0], gap };
+               iov.push_back(g);
+            } else {
+               if (!preadv_all(posixbuf.descriptor(), iov, at)) setstate(std::ios::failbit);
+               iov.clear();
+               at = pos + (p + 1) * period;
+            }
+         }
+#endif
+      } else {
+         for (CMMFile_SIZETYPE p = 0; p < np; p++) {
+            seekg(pos + p * period, std::ios_base::beg);
+            std::fstream::read(out + p * run, p + 1 < np ? run : last);
+         }
+      }
+      if (!fail()) seekg(end, std::ios_base::beg);
+   }
 
-   typedef const char * cstr_type;
+#ifdef CMMFile_POSIX
+   static bool preadv_all(int fd, std::vector<iovec>& iov, std::streamoff off) {
+      size_t k = 0;
+      while (k < iov.size()) {
+         ssize_t r = preadv(fd, &iov[k], int(iov.size() - k), off);
+         if (r < 0 && errno == EINTR) continue;
+         if (r <= 0) return false;
+         off += r;
+         for (; k < iov.size() && size_t(r) >= iov[k].iov_len; k++) r -= iov[k].iov_len;
+         if (k < iov.size()) {
+            iov[k].iov_base = (char *) iov[k].iov_base + r;
+            iov[k].iov_len -= r;
+         }
+      }
+      return true;
+   }
+#endif
 
-   struct header {
-      CMMFile_TYPETYPE type;
-      std::vector<CMMFile_SIZETYPE> dim;
-   };
 
 public:
-   CMMFile() : filename("") {}
-   ~CMMFile() { close(); }
+/****************************************************************************************
+   tiled arrays
+      type CMMFile_TILE for fixed size types of any dimension, data:
+         type of the values (char), number of following bytes (CMMFile_OFFSETTYPE),
+         tile size of each dimension (CMMFile_SIZETYPE), tiles in row major order,
+         each tile row major and padded to the full tile size
+      read_hyperslab reads only the tiles intersecting the requested region, on plain
+      entries it reads only the needed part of each row, with open_read_mmap nothing
+      is read but copied from the mapping, -1 dimensions are not supported
+*****************************************************************************************/
 
-   bool open_write(const std::string & fn)
-   {
-      filename = fn;
-      std::fstream::open(filename.c_str(), std::ios::out | std::ios::binary );
-      return std::fstream::good();
+   template<typename V>
+   inline void write_data_tiled(const V* v, const std::vector<CMMFile_SIZETYPE>& dim, const std::vector<CMMFile_SIZETYPE>& tile) {
+      CMMFile_STATIC_ASSERT(CMMFile_numeric<V>::value, "only numbers are tiled");
+      size_t nd = dim.size();
+      assert(nd > 0 && tile.size() == nd);
+      std::vector<CMMFile_SIZETYPE> grid(nd), dstr(nd, 1), tstr(nd, 1);
+      CMMFile_OFFSETTYPE ntiles = 1;
+      for (size_t d = 0; d < nd; d++) {
+         assert(dim[d] >= 0 && tile[d] > 0);
+         grid[d] = (dim[d] + tile[d] - 1) / tile[d];
+         ntiles *= grid[d];
+      }
+      for (size_t d = nd - 1; d > 0; d--) {
+         dstr[d-1] = dstr[d] * dim[d];
+         tstr[d-1] = tstr[d] * tile[d];
+      }
+      size_t te = tstr[0] * tile[0];
+
+      CMMFile_OFFSETTYPE nb = nd * sizeof(CMMFile_SIZETYPE) + ntiles * te * sizeof(V);
+      write_type(to_type<V>());
+      std::fstream::write((char *) &nb, sizeof(CMMFile_OFFSETTYPE));
+      std::fstream::write((char *) &tile[0], nd * sizeof(CMMFile_SIZETYPE));
+
+      std::vector<V> buf(te);
+      std::vector<CMMFile_SIZETYPE> t(nd, 0), j(nd, 0), ext(nd);
+      for (CMMFile_OFFSETTYPE k = 0; k < ntiles; k++) {
+         std::fill(buf.begin(), buf.end(), V());
+         for (size_t d = 0; d < nd; d++) ext[d] = std::min(tile[d], dim[d] - t[d] * tile[d]);
+         // rows of the tile
+         std::fill(j.begin(), j.end(), 0);
+         do {
+            size_t src = 0, dst = 0;
+            for (size_t d = 0; d < nd; d++) {
+               src += (t[d] * tile[d] + j[d]) * dstr[d];
+               dst += j[d] * tstr[d];
+            }
+            memcpy(&buf[dst], v + src, ext[nd-1] * sizeof(V));
+         } while (next_index(j, ext, nd - 1));
+         std::fstream::write((char *) &buf[0], te * sizeof(V));
+         next_index(t, grid, nd);
+      }
    }
-   
-   bool open_write_append(const std::string & fn)
-   {
-      filename = fn;
-      std::fstream::open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::app);
-      return std::fstream::good();
+
+   template<typename V>
+   inline void write_tiled(const V* v, const std::vector<CMMFile_SIZETYPE>& dim, const std::vector<CMMFile_SIZETYPE>& tile) {
+      write_type(CMMFile_TILE);
+      write_dim(dim);
+      write_data_tiled(v, dim, tile);
    }
-   
 
-   bool open_read(const std::string & fn)
-   {
-      filename = fn;
-      std::fstream::open(filename.c_str(), std::ios::in | std::ios::binary );
-      return std::fstream::good();
+   template<typename V>
+   inline void write_tiled(const std::vector<V>& v, const std::vector<CMMFile_SIZETYPE>& dim, const std::vector<CMMFile_SIZETYPE>& tile) {
+      assert(CMMFile_SIZETYPE(v.size()) == length(dim));
+      write_tiled(v.empty() ? (const V*) 0 : &v[0], dim, tile);
    }
 
-   void close()
-   {
-      std::fstream::close();
-      filename = "";
+   // values start + i * stride, i = 0 ... count - 1 in each dimension of entry e (see get_entry),
+   // in row major order, an empty stride is 1, the stream is positioned at the end of the entry
+   template<typename V>
+   inline void read_hyperslab(std::vector<V>& v, const entry& e,
+                              const std::vector<CMMFile_SIZETYPE>& start, const std::vector<CMMFile_SIZETYPE>& count,
+                              const std::vector<CMMFile_SIZETYPE>& stride = std::vector<CMMFile_SIZETYPE>()) {
+      v.resize(length(count));
+      read_region(v.empty() ? (V *) 0 : &v[0], e.h.type, e.h.dim, e.data, start, count, stride);
    }
 
-public:
-/****************************************************************************************
-   size of types
-*****************************************************************************************/
+   // whole tiled data at the actual position in row major order
+   template<typename V>
+   inline void read_data_tiled(std::vector<V>& v, const std::vector<CMMFile_SIZETYPE>& dim) {
+      std::vector<CMMFile_SIZETYPE> start(dim.size(), 0);
+      v.resize(length(dim));
+      read_region(v.empty() ? (V *) 0 : &v[0], CMMFile_TILE, dim, tellg(), start, dim, std::vector<CMMFile_SIZETYPE>());
+   }
 
-   int size_of(CMMFile_TYPETYPE type) {
-      switch (type) {
-         case CMMFile_REAL: return sizeof(double);
-         case CMMFile_INTG: return sizeof(int);
-         case CMMFile_LONG: return sizeof(long);
-         case CMMFile_ULNG: return sizeof(unsigned long);
-         case CMMFile_TEXT: return sizeof(char);  // null terminated string -> size of one character  !
-         case CMMFile_BOOL: return sizeof(char);
-         default:  std::cout << "Unknow Type:" << type << std::endl;
-                   assert((type ==CMMFile_REAL) || (type ==CMMFile_INTG) || (type ==CMMFile_LONG) 
-                      || (type ==CMMFile_ULNG) || (type ==CMMFile_TEXT) || (type ==CMMFile_BOOL));
+   // next tiled or plain entry of any dimension
+   template<typename V>
+   inline void read_tiled(std::vector<V>& v, std::vector<CMMFile_SIZETYPE>& dim) {
+      header h;
+      read_header(h);
+      dim = h.dim;
+      if (h.type == CMMFile_TILE) {
+         read_data_tiled(v, dim, CMMFile_tag<CMMFile_numeric<V>::value>());
+      } else {
+         read_data_typed(h.type, v, length(dim));
       }
    }
 
-   // calculate number of remaining data points for use with -1 dimensons
-   template <typename V>
-   void tell_size(CMMFile_SIZETYPE& size)
-   {
-      streampos pos = tellg();
-      seekg(0, ios_base::end);
-      streampos end = tellg();
-      seekg(pos, ios_base::beg);
-      size = CMMFile_SIZETYPE((end-pos)/sizeof(V));
+   inline void skip_tiled_data() {
+      read_type();
+      CMMFile_OFFSETTYPE nb;
+      std::fstream::read((char *) &nb, sizeof(CMMFile_OFFSETTYPE));
+      seekg(nb, std::ios_base::cur);
    }
 
-   template <typename V>
-   void tell_size(CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
-      tell_size<V>(size1);
-      size1 = CMMFile_SIZETYPE(size1/size2);
+private:
+   // tiled entries hold numbers, other types of an entry in the file are a type mismatch
+   template<typename V>
+   inline void read_data_tiled(std::vector<V>& v, const std::vector<CMMFile_SIZETYPE>& dim, CMMFile_tag<true>) {
+      read_data_tiled(v, dim);
    }
 
-   // number of entries gived dimensions d
-   inline CMMFile_SIZETYPE length(std::vector<CMMFile_SIZETYPE> d) {
-      CMMFile_SIZETYPE n=1;
-      for (CMMFile_DIMTYPE i=0; i<d.size(); i++) {
-         n*=d[i];
+   template<typename V>
+   inline void read_data_tiled(std::vector<V>&, const std::vector<CMMFile_SIZETYPE>&, CMMFile_tag<false>) {
+      assert(!"tiled entry needs numbers");
+      setstate(std::ios::failbit);
+   }
+
+   // advance row major index i < n in dimensions 0 ... nd - 1, false after the last one
+   static bool next_index(std::vector<CMMFile_SIZETYPE>& i, const std::vector<CMMFile_SIZETYPE>& n, size_t nd) {
+      for (size_t d = nd; d > 0; d--) {
+         if (++i[d-1] < n[d-1]) return true;
+         i[d-1] = 0;
       }
-      return n;
+      return false;
+   }
+
+   // region into v of length(count) values
+   template<typename V>
+   void read_region(V* v, CMMFile_TYPETYPE type, const std::vector<CMMFile_SIZETYPE>& dim, std::streamoff data,
+                    const std::vector<CMMFile_SIZETYPE>& start, const std::vector<CMMFile_SIZETYPE>& count,
+                    const std::vector<CMMFile_SIZETYPE>& stride) {
+      CMMFile_STATIC_ASSERT(CMMFile_numeric<V>::value, "only numbers are tiled");
+      size_t nd = dim.size();
+      assert(nd > 0 && start.size() == nd && count.size() == nd);
+      assert(stride.empty() || stride.size() == nd);
+      std::vector<CMMFile_SIZETYPE> st(nd, 1), tile(nd, 1);
+      if (!stride.empty()) st = stride;
+      clear(rdstate() & ~std::ios::eofbit);   // random access after reading to the end
+
+      // plain entries are tiled in rows
+      std::streamoff base = data, end;
+      if (type == CMMFile_TILE) {
+         seekg(data, std::ios_base::beg);
+         assert(is_type<V>(read_type()));
+         CMMFile_OFFSETTYPE nb;
+         std::fstream::read((char *) &nb, sizeof(CMMFile_OFFSETTYPE));
+         std::fstream::read((char *) &tile[0], nd * sizeof(CMMFile_SIZETYPE));
+         if (fail()) return;
+         base = tellg();
+         end = base - std::streamoff(nd * sizeof(CMMFile_SIZETYPE)) + nb;
+      } else {
+         assert(is_type<V>(type));
+         tile[nd-1] = dim[nd-1];
+         end = data + length(dim) * sizeof(V);
+      }
+
+      std::vector<CMMFile_SIZETYPE> grid(nd), tstr(nd, 1), gstr(nd, 1), ostr(nd, 1);
+      size_t n = 1;
+      for (size_t d = 0; d < nd; d++) {
+         assert(dim[d] >= 0 && tile[d] > 0 && st[d] > 0 && count[d] >= 0);
+         assert(count[d] == 0 || (start[d] >= 0 && start[d] + (count[d] - 1) * st[d] < dim[d]));
+         grid[d] = (dim[d] + tile[d] - 1) / tile[d];
+         n *= count[d];
+      }
+      for (size_t d = nd - 1; d > 0; d--) {
+         tstr[d-1] = tstr[d] * tile[d];
+         gstr[d-1] = gstr[d] * grid[d];
+         ostr[d-1] = ostr[d] * count[d];
+      }
+      size_t te = tstr[0] * tile[0];
+
+      if (n > 0) {
+         // selected i0 ... i1 - 1 in each touched tile of each dimension
+         std::vector< std::vector<CMMFile_SIZETYPE> > tiles(nd), i0(nd), i1(nd);
+         std::vector<CMMFile_SIZETYPE> ns(nd);
+         for (size_t d = 0; d < nd; d++) {
+            for (CMMFile_SIZETYPE i = 0; i < count[d]; ) {
+               CMMFile_SIZETYPE t = (start[d] + i * st[d]) / tile[d];
+               CMMFile_SIZETYPE e = std::min<CMMFile_SIZETYPE>(count[d], ((t + 1) * tile[d] - start[d] + st[d] - 1) / st[d]);
+               tiles[d].push_back(t);
+               i0[d].push_back(i);
+               i1[d].push_back(e);
+               i = e;
+            }
+            ns[d] = tiles[d].size();
+         }
+
+         CMMFile_membuf* m = memory();
+         std::vector<char> buf;
+         std::vector<CMMFile_SIZETYPE> k(nd, 0), j(nd), ext(nd);
+         do {
+            // first and last value of the tile needed
+            size_t tn = 0, lo = 0, hi = 0;
+            for (size_t d = 0; d < nd; d++) {
+               CMMFile_SIZETYPE t = tiles[d][k[d]], o = t * tile[d];
+               tn += t * gstr[d];
+               lo += (start[d] + i0[d][k[d]] * st[d] - o) * tstr[d];
+               hi += (start[d] + (i1[d][k[d]] - 1) * st[d] - o) * tstr[d];
+               ext[d] = i1[d][k[d]] - i0[d][k[d]];
+            }
+            std::streamoff pos = base + std::streamoff((tn * te + lo) * sizeof(V));
+            const char* src;
+            if (m) {
+               // a truncated file leaves v incomplete and the stream failed
+               if (pos + std::streamoff((hi - lo + 1) * sizeof(V)) > std::streamoff(m->size())) {
+                  setstate(std::ios::failbit);
+                  return;
+               }
+               src = m->data() + pos;
+            } else {
+               buf.resize((hi - lo + 1) * sizeof(V));
+               seekg(pos, std::ios_base::beg);
+               std::fstream::read(&buf[0], buf.size());
+               if (fail()) return;
+               src = &buf[0];
+            }
+
+            // rows of the selection in the tile
+            std::fill(j.begin(), j.end(), 0);
+            do {
+               size_t s = 0, o = 0;
+               for (size_t d = 0; d < nd; d++) {
+                  CMMFile_SIZETYPE i = i0[d][k[d]] + j[d];
+                  s += (start[d] + i * st[d] - tiles[d][k[d]] * tile[d]) * tstr[d];
+                  o += i * ostr[d];
+               }
+               s -= lo;
+               char* dst = (char *) (v + o);
+               if (st[nd-1] == 1) {
+                  memcpy(dst, src + s * sizeof(V), ext[nd-1] * sizeof(V));
+               } else {
+                  for (CMMFile_SIZETYPE i = 0; i < ext[nd-1]; i++) {
+                     memcpy(dst + i * sizeof(V), src + (s + i * st[nd-1]) * sizeof(V), sizeof(V));
+                  }
+               }
+            } while (next_index(j, ext, nd - 1));
+         } while (next_index(k, ns, nd));
+      }
+      clear(rdstate() & ~std::ios::eofbit);
+      seekg(end, std::ios_base::beg);
    }
 
+
 public:
 /****************************************************************************************
-   writing raw data 
+   lossy storage of doubles
+      type CMMFile_HALF (IEEE half) and CMMFile_BF16 (bfloat16) store 2 bytes per value,
+      as plain types they may be -1 streams, written with the header and data functions:
+         cmmfile.write_type(CMMFile_HALF); cmmfile.write_dim(-1);
+         cmmfile.write_data_half(v, n); ...   // any number of values at a time
+      type CMMFile_QUANT stores 8 or 16 bit codes of a fixed point grid, data:
+         type of the codes (char), offset and scale (double), codes,
+         value = offset + scale * code, the grid spans the finite values of the entry
+      all are read back into double (or other numbers) with >>,
+      conversions use F16C / AVX2 if compiled for it (e.g. -march=native)
 *****************************************************************************************/
 
-   template<typename V>
-   inline void write_data(const V& v)
-   {
-      std::fstream::write( (char *) &v, sizeof(V) );
+   inline void write_data_half(const double* v, size_t n)     { write_data_lossy(CMMFile_HALF, v, n); }
+   inline void write_data_bfloat16(const double* v, size_t n) { write_data_lossy(CMMFile_BF16, v, n); }
+
+   inline void write_half(const double* v, const std::vector<CMMFile_SIZETYPE>& dim) {
+      for (size_t d = 0; d < dim.size(); d++) assert(dim[d] >= 0);   // length(dim) values of v
+      write_type(CMMFile_HALF);
+      write_dim(dim);
+      write_data_half(v, length(dim));
    }
 
-   template<typename V>
-   inline void write_data(const std::vector<V>& v)
-   {
-      std::fstream::write( (char *) &v[0], v.size() * sizeof(V) );
+   inline void write_half(const std::vector<double>& v) {
+      write_half(v.empty() ? 0 : &v[0], std::vector<CMMFile_SIZETYPE>(1, v.size()));
    }
 
+   inline void write_bfloat16(const double* v, const std::vector<CMMFile_SIZETYPE>& dim) {
+      for (size_t d = 0; d < dim.size(); d++) assert(dim[d] >= 0);   // length(dim) values of v
+      write_type(CMMFile_BF16);
+      write_dim(dim);
+      write_data_bfloat16(v, length(dim));
+   }
 
-   template<typename V>
-   inline void write_data(const std::vector< std::vector<V> >& v) {
-      assert(v.size()>0);
-      CMMFile_SIZETYPE size = v[0].size();
-      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
-         assert(size == it->size());
+   inline void write_bfloat16(const std::vector<double>& v) {
+      write_bfloat16(v.empty() ? 0 : &v[0], std::vector<CMMFile_SIZETYPE>(1, v.size()));
+   }
+
+   // bits 8 or 16, non finite values are stored as the nearest end of the grid (NaN as offset)
+   inline void write_data_quantized(const double* v, size_t n, int bits = 16) {
+      assert(bits == 8 || bits == 16);
+      double lo = std::numeric_limits<double>::max(), hi = -lo;
+      for (size_t i = 0; i < n; i++) {
+         if (v[i] - v[i] != 0) continue;   // not finite
+         if (v[i] < lo) lo = v[i];
+         if (v[i] > hi) hi = v[i];
       }
-      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
-         std::fstream::write( (char *) &((*it)[0]), size  * sizeof(V) );
+      if (lo > hi) lo = hi = 0;
+      double m = (1 << bits) - 1;
+      double q[2] = {lo, (hi - lo) / m};   // offset, scale
+      write_type(bits == 8 ? CMMFile_UINT8 : CMMFile_UINT16);
+      std::fstream::write((char *) q, sizeof(q));
+      if (bits == 8) {
+         write_codes<unsigned char>(v, n, lo, q[1] > 0 ? 1 / q[1] : 0, m);
+      } else {
+         write_codes<unsigned short>(v, n, lo, q[1] > 0 ? 1 / q[1] : 0, m);
       }
    }
 
+   inline void write_quantized(const double* v, const std::vector<CMMFile_SIZETYPE>& dim, int bits = 16) {
+      for (size_t d = 0; d < dim.size(); d++) assert(dim[d] >= 0);   // the grid needs all values
+      write_type(CMMFile_QUANT);
+      write_dim(dim);
+      write_data_quantized(v, length(dim), bits);
+   }
+
+   inline void write_quantized(const std::vector<double>& v, int bits = 16) {
+      write_quantized(v.empty() ? 0 : &v[0], std::vector<CMMFile_SIZETYPE>(1, v.size()), bits);
+   }
 
+   // values of lossy type t converted to V
    template<typename V, typename S>
-   inline void write_data(const V* v, const S& size) {
-      std::fstream::write( (char *) v, size * sizeof(V) );
+   inline void read_data_lossy(const CMMFile_TYPETYPE& t, std::vector<V>& v, const S& size) {
+      std::vector<double> w;
+      read_data_lossy(t, w, size);
+      cast_values(w, v);
    }
 
-   template<typename V, typename S>
-   inline void write_data(const V** v, const S& size1, const S& size2) {
-      for (S i = 0; i < size1; i++) {
-         std::fstream::write( (char *) &(v[i]), size2  * sizeof(V) );
+   template<typename S>
+   inline void read_data_lossy(const CMMFile_TYPETYPE& t, std::vector<double>& v, const S& size) {
+      if (t == CMMFile_QUANT) {
+         read_data_quantized(v, size);
+         return;
+      }
+      assert(t == CMMFile_HALF || t == CMMFile_BF16);
+      CMMFile_SIZETYPE n = size;
+      if (n < 0) tell_size<unsigned short>(n);
+      v.resize(n);
+      unsigned short b[4096];
+      for (CMMFile_SIZETYPE i = 0; i < n; i += 4096) {
+         size_t k = std::min<CMMFile_SIZETYPE>(4096, n - i);
+         std::fstream::read((char *) b, k * sizeof(unsigned short));
+         if (t == CMMFile_HALF) {
+            decode_half(b, &v[i], k);
+         } else {
+            decode_bfloat16(b, &v[i], k);
+         }
       }
    }
 
+   template<typename S>
+   inline void read_data_quantized(std::vector<double>& v, const S& size) {
+      assert(size >= 0);
+      CMMFile_TYPETYPE c = read_type();
+      double q[2];
+      std::fstream::read((char *) q, sizeof(q));
+      v.resize(size);
+      if (c == CMMFile_UINT8) {
+         read_codes<unsigned char>(v, q[0], q[1]);
+      } else {
+         assert(c == CMMFile_UINT16);
+         read_codes<unsigned short>(v, q[0], q[1]);
+      }
+   }
 
-public:
-/****************************************************************************************
-   reading raw data 
-*****************************************************************************************/
+   inline void skip_quantized_data(CMMFile_SIZETYPE n) {
+      CMMFile_TYPETYPE c = read_type();
+      seekg(2 * sizeof(double) + n * size_of(c), std::ios_base::cur);
+   }
 
+   // conversion of n values, rounding to nearest even as the hardware does
+   static void encode_half(const double* v, unsigned short* h, size_t n) {
+      size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+      for (; i + 8 <= n; i += 8) {
+         __m256 f = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(_mm256_loadu_pd(v + i))),
+                                         _mm256_cvtpd_ps(_mm256_loadu_pd(v + i + 4)), 1);
+         _mm_storeu_si128((__m128i *) (h + i), _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+      }
+#endif
+      for (; i < n; i++) h[i] = float_to_half(float(v[i]));
+   }
 
-   template<typename V>
-   inline void read_data(V& v) {
-      std::fstream::read((char *) & v , sizeof(V));
+   static void decode_half(const unsigned short* h, double* v, size_t n) {
+      size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+      for (; i + 8 <= n; i += 8) {
+         __m256 f = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *) (h + i)));
+         _mm256_storeu_pd(v + i, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+         _mm256_storeu_pd(v + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+      }
+#endif
+      for (; i < n; i++) v[i] = half_to_float(h[i]);
    }
 
-   template<typename V, typename S>
-   inline void read_data(std::vector<V>& v, const S& size)
-   {
-      assert(size >= -1);
-      S s = size;
-      if (s<0) tell_size<V>(s);
-      v.resize(s);
-      std::fstream::read((char *) & v[0] , s*sizeof(V));
+   static void encode_bfloat16(const double* v, unsigned short* h, size_t n) {
+      size_t i = 0;
+#ifdef __AVX2__
+      const __m256i one = _mm256_set1_epi32(1), round = _mm256_set1_epi32(0x7fff), quiet = _mm256_set1_epi32(0x40);
+      for (; i + 8 <= n; i += 8) {
+         __m256 f = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(_mm256_loadu_pd(v + i))),
+                                         _mm256_cvtpd_ps(_mm256_loadu_pd(v + i + 4)), 1);
+         __m256i x = _mm256_castps_si256(f), hi = _mm256_srli_epi32(x, 16);
+         __m256i r = _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_add_epi32(round, _mm256_and_si256(hi, one))), 16);
+         r = _mm256_blendv_epi8(r, _mm256_or_si256(hi, quiet), _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q)));
+         r = _mm256_permute4x64_epi64(_mm256_packus_epi32(r, r), 0xd8);
+         _mm_storeu_si128((__m128i *) (h + i), _mm256_castsi256_si128(r));
+      }
+#endif
+      for (; i < n; i++) h[i] = float_to_bfloat16(float(v[i]));
    }
 
-   template<typename V, typename S>
-   inline void read_data(std::vector< std::vector<V> >& v, const S& size1, const S& size2)
-   {
-      assert(size1 >= -1);
-      S s = size1;
-      if (s<0) tell_size<V>(s, size2);
-      v.resize(s);
-      for (typename std::vector< std::vector<V> >::iterator it = v.begin(); it != v.end(); it++)
-      {
-         it -> resize(size2);
-         std::fstream::read( (char *) &((*it)[0]), size2* sizeof(V) );
+   static void decode_bfloat16(const unsigned short* h, double* v, size_t n) {
+      size_t i = 0;
+#ifdef __AVX2__
+      for (; i + 8 <= n; i += 8) {
+         __m256i x = _mm256_slli_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (h + i))), 16);
+         __m256 f = _mm256_castsi256_ps(x);
+         _mm256_storeu_pd(v + i, _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+         _mm256_storeu_pd(v + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+      }
+#endif
+      for (; i < n; i++) {
+         unsigned int x = (unsigned int) h[i] << 16;
+         float f;
+         memcpy(&f, &x, sizeof(float));
+         v[i] = f;
       }
    }
 
-   template<typename V, typename S>
-   inline void read_data(V*& v, const S& size)
-   {
-      assert(size >= -1);
-      S s = size;
-      if (s<0) tell_size<V>(s);
-      v = new V[s];
-      std::fstream::read((char *) & v[0] , s * sizeof(V));
+private:
+   inline void write_data_lossy(CMMFile_TYPETYPE t, const double* v, size_t n) {
+      unsigned short b[4096];
+      for (size_t i = 0; i < n; i += 4096) {
+         size_t k = std::min<size_t>(4096, n - i);
+         if (t == CMMFile_HALF) {
+            encode_half(v + i, b, k);
+         } else {
+            encode_bfloat16(v + i, b, k);
+         }
+         std::fstream::write((char *) b, k * sizeof(unsigned short));
+      }
    }
 
-   template<typename V, typename S>
-   inline void read_data(V**& v, const S& size1, const S& size2)
-   {
-      assert(size1 >= -1);
-      S s = size1;
-      if (s==-1) tell_size<V>(s,size2);
-      v = new V*[s];
-      for (CMMFile_SIZETYPE i = 1; i< s; i++) {
-         v[i] = new V[size2];
-         std::fstream::read((char *) v[i] , size2 * sizeof(V));
+   template<typename W>
+   inline void write_codes(const double* v, size_t n, double offset, double inverse, double m) {
+      W b[4096];
+      for (size_t i = 0; i < n; i += 4096) {
+         size_t k = std::min<size_t>(4096, n - i);
+         for (size_t j = 0; j < k; j++) {
+            double x = (v[i + j] - offset) * inverse + 0.5;
+            b[j] = W(x > 0 ? (x < m ? x : m) : 0);
+         }
+         std::fstream::write((char *) b, k * sizeof(W));
+      }
+   }
+
+   template<typename W>
+   inline void read_codes(std::vector<double>& v, double offset, double scale) {
+      W b[4096];
+      for (size_t i = 0; i < v.size(); i += 4096) {
+         size_t k = std::min<size_t>(4096, v.size() - i);
+         std::fstream::read((char *) b, k * sizeof(W));
+         for (size_t j = 0; j < k; j++) v[i + j] = offset + scale * b[j];
+      }
+   }
+
+   static unsigned short float_to_half(float f) {
+      unsigned int x;
+      memcpy(&x, &f, sizeof(float));
+      unsigned int sign = (x >> 16) & 0x8000, m = x & 0x7fffff;
+      int e = int((x >> 23) & 0xff) - 127 + 15;
+      if (e == 128 + 15) return sign | 0x7c00 | (m ? 0x200 | (m >> 13) : 0);   // inf, nan
+      if (e >= 31) return sign | 0x7c00;
+      if (e <= 0) {
+         // subnormal half
+         if (e < -10) return sign;
+         m |= 0x800000;
+         int s = 14 - e;
+         unsigned int h = m >> s, r = m & ((1u << s) - 1), half = 1u << (s - 1);
+         if (r > half || (r == half && (h & 1))) h++;
+         return sign | h;
+      }
+      unsigned int h = (e << 10) | (m >> 13), r = m & 0x1fff;
+      if (r > 0x1000 || (r == 0x1000 && (h & 1))) h++;   // a carry gives the next exponent or inf
+      return sign | h;
+   }
+
+   static float half_to_float(unsigned short h) {
+      unsigned int sign = (unsigned int) (h & 0x8000) << 16, e = (h >> 10) & 0x1f, m = h & 0x3ff, x;
+      if (e == 0x1f) {
+         x = sign | 0x7f800000 | (m << 13);
+      } else if (e == 0) {
+         if (m == 0) {
+            x = sign;
+         } else {
+            // subnormal half, normalized as float
+            e = 127 - 15 + 1;
+            while (!(m & 0x400)) {
+               m <<= 1;
+               e--;
+            }
+            x = sign | (e << 23) | ((m & 0x3ff) << 13);
+         }
+      } else {
+         x = sign | ((e + 127 - 15) << 23) | (m << 13);
       }
+      float f;
+      memcpy(&f, &x, sizeof(float));
+      return f;
+   }
+
+   static unsigned short float_to_bfloat16(float f) {
+      unsigned int x;
+      memcpy(&x, &f, sizeof(float));
+      if (f != f) return (unsigned short) ((x >> 16) | 0x40);
+      return (unsigned short) ((x + 0x7fff + ((x >> 16) & 1)) >> 16);
    }
 
 
@@ -297,6 +3296,7 @@ public:
    inline void write_dim() {
       CMMFile_DIMTYPE dim = 0;
       std::fstream::write( (char *) &dim, sizeof(CMMFile_DIMTYPE));
+      if (index_pending) index_entry(std::vector<CMMFile_SIZETYPE>());
    }
 
    //1D vector
@@ -304,6 +3304,7 @@ public:
       CMMFile_DIMTYPE dim = 1;
       std::fstream::write( (char *) &dim, sizeof(CMMFile_DIMTYPE));
       std::fstream::write( (char *) &size, sizeof(CMMFile_SIZETYPE));
+      if (index_pending) index_entry(std::vector<CMMFile_SIZETYPE>(1, size));
    }
 
    //2D array
@@ -312,6 +3313,10 @@ public:
       std::fstream::write( (char *) &dim, sizeof(CMMFile_DIMTYPE));
       std::fstream::write( (char *) &size1, sizeof(CMMFile_DIMTYPE));
       std::fstream::write( (char *) &size2, sizeof(CMMFile_DIMTYPE));
+      if (index_pending) {
+         CMMFile_SIZETYPE d[] = {size1, size2};
+         index_entry(std::vector<CMMFile_SIZETYPE>(d, d + 2));
+      }
    }
    
    //3D array
@@ -321,12 +3326,17 @@ public:
       std::fstream::write( (char *) &size1, sizeof(CMMFile_DIMTYPE));
       std::fstream::write( (char *) &size2, sizeof(CMMFile_DIMTYPE));
       std::fstream::write( (char *) &size3, sizeof(CMMFile_DIMTYPE));
+      if (index_pending) {
+         CMMFile_SIZETYPE d[] = {size1, size2, size3};
+         index_entry(std::vector<CMMFile_SIZETYPE>(d, d + 3));
+      }
    }
 
    inline void write_dim(std::vector<CMMFile_DIMTYPE> size) {
       CMMFile_DIMTYPE dim = size.size();
       std::fstream::write( (char *) &dim, sizeof(CMMFile_DIMTYPE));
-      std::fstream::write( (char *) &size[0], size.size()*sizeof(CMMFile_DIMTYPE));
+      if (dim > 0) std::fstream::write( (char *) &size[0], size.size()*sizeof(CMMFile_DIMTYPE));
+      if (index_pending) index_entry(size);
    }
 
 
@@ -368,6 +3378,7 @@ public:
    inline void write_type()  { write_type(to_type<V>()); }
 
    inline void write_type(const CMMFile_TYPETYPE& type) {
+      if (index_on_close) index_type(type);
       std::fstream::write(&type, sizeof(CMMFile_TYPETYPE));
    }
 
@@ -485,7 +3496,7 @@ public:
 
    template<typename V>
    inline void write(const std::vector< std::vector<V> >& v) {
-      write_header<V>(v.size(), v[0].size());
+      write_header<V>(v.size(), v.empty() ? 0 : v[0].size());
       write_data(v);
    }
 
@@ -510,46 +3521,98 @@ public:
 
    template<typename V>
    inline void read(V& v) {
-      assert(is_type<V>(read_type()));
+      CMMFile_TYPETYPE t = read_type();
       assert(read_dim() == 0);
-      read_data(v);
+      read_data_typed(t, v);
    }
 
    template<typename V>
    inline void read(std::vector<V>& v) {
-      assert(is_type<V>(read_type()));
+      CMMFile_TYPETYPE t = read_type();
       assert(read_dim() == 1);
-      read_data(v, read_size());
+      read_data_typed(t, v, read_size());
    }
 
    template<typename V>
    inline void read(std::vector< std::vector<V> >& v) {
-      assert(is_type<V>(read_type()));
+      CMMFile_TYPETYPE t = read_type();
       assert(read_dim() == 2);
       CMMFile_SIZETYPE size1 = read_size();
       CMMFile_SIZETYPE size2 = read_size();
+      read_data_typed(t, v, size1, size2);
+   }
+
+   template<typename V, typename S>
+   inline void read(V*& v, S& size) {
+      assert(is_type<V>(read_type()));
+      assert(read_dim() == 1);
+      size = read_size();
+      read_data(v, size);
+   }
+
+   template<typename V, typename S>
+   inline void read(V**& v, S& size1, S& size2) {
+      assert(is_type<V>(read_type()));
+      assert(read_dim() == 2);
+      size1 = read_size();
+      size2 = read_size();
       read_data(v, size1, size2);
    }
 
-   template<typename V, typename S>
-   inline void read(V*& v, S& size) {
-      assert(is_type<V>(read_type()));
-      assert(read_dim() == 1);
-      size = read_size();
-      read_data(v, size);
+
+
+public:
+/****************************************************************************************
+   zero copy views into memory mapped files (open_read_mmap, open_read_memory)
+      views are valid until close(), headers are packed so data is in general
+      not aligned for V, CMMFile_view loads the values with memcpy
+*****************************************************************************************/
+
+   template<typename V>
+   inline CMMFile_view<V> view_data(const CMMFile_SIZETYPE& size) {
+      CMMFile_membuf* m = memory();
+      assert(m);
+      assert(size >= 0);
+      std::streamoff pos = tellg();
+      assert(pos + std::streamoff(size * sizeof(V)) <= std::streamoff(m->size()));
+      seekg(size * sizeof(V), std::ios_base::cur);
+      return CMMFile_view<V>(m->data() + pos);
+   }
+
+   // view data of next entry, -1 dimensions are resolved to the actual size
+   template<typename V>
+   inline CMMFile_view<V> read_view(std::vector<CMMFile_SIZETYPE>& dim) {
+      header h;
+      read_header(h);
+      assert(is_type<V>(h.type));
+      dim = h.dim;
+      if (dim.size() > 0 && dim[0] == -1) {
+         dim[0] = 1;
+         tell_size<V>(dim[0], length(dim));
+      }
+      return view_data<V>(length(dim));
+   }
+
+   template<typename V>
+   inline CMMFile_view<V> read_view(CMMFile_SIZETYPE& size) {
+      std::vector<CMMFile_SIZETYPE> dim;
+      CMMFile_view<V> v = read_view<V>(dim);
+      assert(dim.size() == 1);
+      size = dim[0];
+      return v;
    }
 
-   template<typename V, typename S>
-   inline void read(V**& v, S& size1, S& size2) {
-      assert(is_type<V>(read_type()));
-      assert(read_dim() == 2);
-      size1 = read_size();
-      size2 = read_size();
-      read_data(v, size1, size2);
+   template<typename V>
+   inline CMMFile_view<V> read_view(CMMFile_SIZETYPE& size1, CMMFile_SIZETYPE& size2) {
+      std::vector<CMMFile_SIZETYPE> dim;
+      CMMFile_view<V> v = read_view<V>(dim);
+      assert(dim.size() == 2);
+      size1 = dim[0];
+      size2 = dim[1];
+      return v;
    }
 
 
-
    // operators
 
    template<typename V>
@@ -584,10 +3647,18 @@ public:
    }
 
    void write_end_sequence()   {
+      reset_sequence_state();
       actual_header = header_sequence.begin();
       write_type(CMMFile_SEQE);
    }
 
+   void reset_sequence_state() {
+      for (header_sequence_type::iterator it = header_sequence.begin(); it != header_sequence.end(); it++) {
+         it->last[0] = 0;
+         it->last[1] = 0;
+      }
+   }
+
    void increase_actual_header() {
       actual_header++;
       if (actual_header == header_sequence.end()) actual_header =  header_sequence.begin();
@@ -621,6 +3692,22 @@ public:
       write_header_sequence(h);
    }
 
+   // integer vector column stored delta varint coded, see write_data_varint
+   inline void write_header_sequence_varint(const CMMFile_SIZETYPE& size) {
+      header h;
+      h.type = CMMFile_VINT;
+      h.dim.push_back(size);
+      write_header_sequence(h);
+   }
+
+   // scalar double column stored xor delta coded, see write_data_xor
+   inline void write_header_sequence_xor() {
+      header h;
+      h.type = CMMFile_XREL;
+      h.dim.clear();
+      write_header_sequence(h);
+   }
+
    template<typename V>
    inline void write_header_sequence(const std::vector<CMMFile_SIZETYPE>& dim) {
       header h;
@@ -648,17 +3735,20 @@ public:
    template<typename V>
    inline void write_data_sequence(const V& v) {
       //check if correct data
-      assert((*actual_header).type == to_type<V>());
       assert((*actual_header).dim.size() == 0);
-
-      write_data<V>(v);
+      if ((*actual_header).type == CMMFile_XREL) {
+         write_data_xor(*actual_header, v, CMMFile_tag<CMMFile_numeric<V>::value>());
+      } else {
+         assert((*actual_header).type == to_type<V>());
+         write_data<V>(v);
+      }
       increase_actual_header();
    }
 
    template<typename V>
    inline void write_data_sequence(const std::vector<V>& v) {
       //check if correct data
-      assert((*actual_header).type == to_type<V>());
+      assert((*actual_header).type == to_type<V>() || ((*actual_header).type == CMMFile_VINT && CMMFile_integer<V>::value));
       assert((*actual_header).dim.size() == 1);
 
       if ((*actual_header).dim[0] == -1) {
@@ -667,14 +3757,18 @@ public:
          assert((*actual_header).dim[0] == v.size());
       }
 
-      write_data<V>(v);
+      if ((*actual_header).type == CMMFile_VINT) {
+         write_data_varint(v, CMMFile_tag<CMMFile_integer<V>::value>());
+      } else {
+         write_data<V>(v);
+      }
       increase_actual_header();
    }
 
    template<typename V>
    inline void write_data_sequence(const std::vector< std::vector<V> >& v) {
       //check if correct data
-      assert((*actual_header).type == to_type<V>());
+      assert((*actual_header).type == to_type<V>() || ((*actual_header).type == CMMFile_VINT && CMMFile_integer<V>::value));
       assert((*actual_header).dim.size() == 2);
 
       if ((*actual_header).dim[0] == -1) {
@@ -682,9 +3776,13 @@ public:
       } else {
          assert((*actual_header).dim[0] == v.size());
       }
-      assert((*actual_header).dim[1] == v[0].size());
+      assert(v.empty() || (*actual_header).dim[1] == v[0].size());
 
-      write_data<V>(v);
+      if ((*actual_header).type == CMMFile_VINT) {
+         write_data_varint(v, CMMFile_tag<CMMFile_integer<V>::value>());
+      } else if (!v.empty()) {
+         write_data<V>(v);
+      }
       increase_actual_header();
    }
 
@@ -715,7 +3813,7 @@ public:
       } else {
          assert((*actual_header).dim[0] == size1);
       }
-      assert((*actual_header).dim[1] == v[0].size());
+      assert((*actual_header).dim[1] == size2);
 
       write_data<V>(v, size1, size2);
       increase_actual_header();
@@ -723,33 +3821,120 @@ public:
 
    template<typename V>
    inline void read_data_sequence(V& v) {
-      assert((*actual_header).type == to_type<V>());
       assert((*actual_header).dim.size() == 0);
-      read_data(v);
+      if ((*actual_header).type == CMMFile_XREL) {
+         read_data_xor(*actual_header, v, CMMFile_tag<CMMFile_numeric<V>::value>());
+      } else {
+         read_data_typed((*actual_header).type, v);
+      }
       increase_actual_header();
    }
 
-   template<typename V>
-   inline void read_data_sequence(std::vector<V>& v) {
-      assert((*actual_header).type == to_type<V>());
+   template<typename V, typename A>
+   inline void read_data_sequence(std::vector<V, A>& v) {
       assert((*actual_header).dim.size() == 1);
       CMMFile_SIZETYPE size = (*actual_header).dim[0];
       if (size ==-1) size = read_size();
-      read_data(v, size);
+      read_data_typed((*actual_header).type, v, size);
       increase_actual_header();
    }
 
-   template<typename V>
-   inline void read_data_sequence(std::vector< std::vector<V> >& v) {
-      assert((*actual_header).type == to_type<V>());
+   template<typename V, typename A1, typename A2>
+   inline void read_data_sequence(std::vector< std::vector<V, A1>, A2 >& v) {
       assert((*actual_header).dim.size() == 2);
       CMMFile_SIZETYPE size1 = (*actual_header).dim[0];
       CMMFile_SIZETYPE size2 = (*actual_header).dim[1];
       if (size1 ==-1) size1 = read_size();
-      read_data(v, size1, size2);
+      read_data_typed((*actual_header).type, v, size1, size2);
       increase_actual_header();
    }
 
+   // xor delta coding of scalar double columns (CMMFile_XREL):
+   //    the value is xored with a prediction from the last two values of the column,
+   //    either the last value or the linear extrapolation, whichever leaves fewer bytes,
+   //    stored are a control byte (bit 7: extrapolation, bits 3-6: leading zero bytes,
+   //    bits 0-2: trailing zero bytes) and the remaining bytes of the xor
+   inline void write_data_xor(header& h, const double& v) {
+      unsigned long long b, p0, p1;
+      double e = 2 * h.last[0] - h.last[1];
+      memcpy(&b, &v, 8);
+      memcpy(&p0, &h.last[0], 8);
+      memcpy(&p1, &e, 8);
+      unsigned long long x0 = b ^ p0, x1 = b ^ p1;
+      int l0, t0, l1, t1;
+      zero_bytes(x0, l0, t0);
+      zero_bytes(x1, l1, t1);
+
+      unsigned char c[9];
+      unsigned long long x = x0;
+      int l = l0, t = t0;
+      c[0] = 0;
+      if (l1 + t1 > l0 + t0) {
+         x = x1; l = l1; t = t1;
+         c[0] = 0x80;
+      }
+      c[0] |= (unsigned char) ((l << 3) | t);
+      int n = 8 - l - t;
+      x >>= 8 * t;
+      for (int i = 0; i < n; i++, x >>= 8) c[1 + i] = (unsigned char) (x & 0xff);
+      std::fstream::write((char *) c, 1 + n);
+
+      h.last[1] = h.last[0];
+      h.last[0] = v;
+   }
+
+   inline void read_data_xor(header& h, double& v) {
+      unsigned char c[9];
+      std::fstream::read((char *) c, 1);
+      int l = (c[0] >> 3) & 0xf, t = c[0] & 0x7;
+      int n = 8 - l - t;
+      assert(n >= 0);
+      if (n > 0) std::fstream::read((char *) c + 1, n);
+      unsigned long long x = 0, p;
+      for (int i = n - 1; i >= 0; i--) x = (x << 8) | c[1 + i];
+      x <<= 8 * t;
+      double e = (c[0] & 0x80) ? 2 * h.last[0] - h.last[1] : h.last[0];
+      memcpy(&p, &e, 8);
+      x ^= p;
+      memcpy(&v, &x, 8);
+
+      h.last[1] = h.last[0];
+      h.last[0] = v;
+   }
+
+   // xor coded columns hold doubles, other numbers are converted,
+   // other types of a column of the file are a type mismatch
+   template<typename V>
+   inline void write_data_xor(header& h, const V& v, CMMFile_tag<true>) { write_data_xor(h, double(v)); }
+
+   template<typename V>
+   inline void write_data_xor(header&, const V&, CMMFile_tag<false>) {
+      assert(!"xor coded column needs a number");
+      setstate(std::ios::failbit);
+   }
+
+   template<typename V>
+   inline void read_data_xor(header& h, V& v, CMMFile_tag<true>) {
+      double x;
+      read_data_xor(h, x);
+      v = V(x);
+   }
+
+   template<typename V>
+   inline void read_data_xor(header&, V&, CMMFile_tag<false>) {
+      assert(!"xor coded column needs a number");
+      setstate(std::ios::failbit);
+   }
+
+   // number of leading and trailing zero bytes (at most 7) of x, x = 0 has 8 leading ones
+   static void zero_bytes(unsigned long long x, int& lead, int& trail) {
+      lead = 0;
+      trail = 0;
+      if (x == 0) { lead = 8; return; }
+      while (!((x >> (56 - 8 * lead)) & 0xff)) lead++;
+      while (!((x >> (8 * trail)) & 0xff)) trail++;
+   }
+
    // read a sequence of headers and store in header_sequence
    void read_header_sequence() {
       assert(read_type() == CMMFile_SEQS);
@@ -762,11 +3947,13 @@ public:
          header_sequence.push_back(h);
       }
       assert(read_type() == CMMFile_SEQE);
+      reset_sequence_state();
       actual_header = header_sequence.begin();
    }
 
-   template <typename V1, typename V2>
-   void read_sequence(std::vector<V1>& v1, std::vector<V2>& v2) {
+   // records are read in place at the end of the column vectors
+   template <typename V1, typename A1, typename V2, typename A2>
+   void read_sequence(std::vector<V1, A1>& v1, std::vector<V2, A2>& v2) {
       read_header_sequence();
 
       /*
@@ -777,65 +3964,369 @@ public:
 
       assert(header_sequence.size() == 2);
       v1.clear(); v2.clear();
-      V1 e1; V2 e2;
 
       while (!eof()) {
-         read_data_sequence(e1);
-         v1.push_back(e1);
-         peek();
-         assert(!eof());
-         read_data_sequence(e2);
-         v2.push_back(e2);
+         v1.resize(v1.size() + 1);
+         read_data_sequence(v1.back());
+         v2.resize(v2.size() + 1);
+         read_data_sequence(v2.back());
          peek();
       }
    }
 
-   template <typename V1, typename V2, typename V3>
-   void read_sequence(std::vector<V1>& v1, std::vector<V2>& v2, std::vector<V3>& v3) {
+   template <typename V1, typename A1, typename V2, typename A2, typename V3, typename A3>
+   void read_sequence(std::vector<V1, A1>& v1, std::vector<V2, A2>& v2, std::vector<V3, A3>& v3) {
       read_header_sequence();
       assert(header_sequence.size() == 3);
       v1.clear(); v2.clear(); v3.clear();
-      V1 e1; V2 e2; V3 e3;
       while (!eof()) {
-         read_data_sequence(e1);
-         v1.push_back(e1);
-         peek();
-         assert(!eof());
-         read_data_sequence(e2);
-         v2.push_back(e2);
+         v1.resize(v1.size() + 1);
+         read_data_sequence(v1.back());
+         v2.resize(v2.size() + 1);
+         read_data_sequence(v2.back());
          peek();
          assert(!eof());    
-         read_data_sequence(e3);
-         v3.push_back(e3);
+         v3.resize(v3.size() + 1);
+         read_data_sequence(v3.back());
          peek();
       }
    }
 
-   template <typename V1, typename V2, typename V3, typename V4>
-   void read_data_sequence(std::vector<V1>& v1, std::vector<V2>& v2, std::vector<V3>& v3, std::vector<V4>& v4) {
+   template <typename V1, typename A1, typename V2, typename A2, typename V3, typename A3, typename V4, typename A4>
+   void read_sequence(std::vector<V1, A1>& v1, std::vector<V2, A2>& v2, std::vector<V3, A3>& v3, std::vector<V4, A4>& v4) {
       read_header_sequence();
       assert(header_sequence.size() == 4);
       v1.clear(); v2.clear(); v3.clear(); v4.clear();
-      V1 e1; V2 e2; V3 e3; V4 e4;
       while (!eof()) {
-         read_data_sequence(e1);
-         v1.push_back(e1);
+         v1.resize(v1.size() + 1);
+         read_data_sequence(v1.back());
+         v2.resize(v2.size() + 1);
+         read_data_sequence(v2.back());
+         v3.resize(v3.size() + 1);
+         read_data_sequence(v3.back());
+         v4.resize(v4.size() + 1);
+         read_data_sequence(v4.back());
+         peek();
+      }
+   }
+
+   // former name of read_sequence for four columns
+   template <typename V1, typename A1, typename V2, typename A2, typename V3, typename A3, typename V4, typename A4>
+   void read_data_sequence(std::vector<V1, A1>& v1, std::vector<V2, A2>& v2, std::vector<V3, A3>& v3, std::vector<V4, A4>& v4) {
+      read_sequence(v1, v2, v3, v4);
+   }
+
+
+public:
+/****************************************************************************************
+   columnar sequences
+      read_columns reads the sequence column wise into CMMFile_column, the values of each
+      record are appended to the flat buffer of its column, columns with a -1 first
+      dimension or without values get offsets of the records
+*****************************************************************************************/
+
+   template<typename V1>
+   void read_columns(CMMFile_column<V1>& c1) {
+      read_header_sequence();
+      assert(header_sequence.size() == 1);
+      init_column(c1, header_sequence[0]);
+      while (!eof()) {
+         read_column_record(c1);
          peek();
-         assert(!eof());
-         read_data_sequence(e2);
-         v2.push_back(e2);
+      }
+   }
+
+   template<typename V1, typename V2>
+   void read_columns(CMMFile_column<V1>& c1, CMMFile_column<V2>& c2) {
+      read_header_sequence();
+      assert(header_sequence.size() == 2);
+      init_column(c1, header_sequence[0]);
+      init_column(c2, header_sequence[1]);
+      while (!eof()) {
+         read_column_record(c1);
+         read_column_record(c2);
          peek();
-         assert(!eof());
-         read_data_sequence(e3);
-         v3.push_back(e3);
+      }
+   }
+
+   template<typename V1, typename V2, typename V3>
+   void read_columns(CMMFile_column<V1>& c1, CMMFile_column<V2>& c2, CMMFile_column<V3>& c3) {
+      read_header_sequence();
+      assert(header_sequence.size() == 3);
+      init_column(c1, header_sequence[0]);
+      init_column(c2, header_sequence[1]);
+      init_column(c3, header_sequence[2]);
+      while (!eof()) {
+         read_column_record(c1);
+         read_column_record(c2);
+         read_column_record(c3);
          peek();
-         assert(!eof());
-         read_data_sequence(e4);
-         v4.push_back(e4);
+      }
+   }
+
+   template<typename V1, typename V2, typename V3, typename V4>
+   void read_columns(CMMFile_column<V1>& c1, CMMFile_column<V2>& c2, CMMFile_column<V3>& c3, CMMFile_column<V4>& c4) {
+      read_header_sequence();
+      assert(header_sequence.size() == 4);
+      init_column(c1, header_sequence[0]);
+      init_column(c2, header_sequence[1]);
+      init_column(c3, header_sequence[2]);
+      init_column(c4, header_sequence[3]);
+      while (!eof()) {
+         read_column_record(c1);
+         read_column_record(c2);
+         read_column_record(c3);
+         read_column_record(c4);
          peek();
       }
    }
 
+private:
+   friend class CMMFile_follow;   // appends new records of a growing file
+
+   template<typename V>
+   void init_column(CMMFile_column<V>& c, const header& h) {
+      c.values.clear();
+      c.offsets.clear();
+      c.stride = (h.dim.size() > 0 && h.dim[0] == -1) ? 0 : length(h.dim);
+      // records without values are only counted by their offsets
+      if (c.stride == 0) c.offsets.push_back(0);
+   }
+
+   // append the values of the actual header to c
+   template<typename V>
+   void read_column_record(CMMFile_column<V>& c) {
+      header& h = *actual_header;
+      if (h.type == CMMFile_XREL) {
+         V x;
+         read_data_xor(h, x, CMMFile_tag<CMMFile_numeric<V>::value>());
+         c.values.push_back(x);
+      } else {
+         CMMFile_SIZETYPE n = length(h.dim);
+         if (h.dim.size() > 0 && h.dim[0] == -1) n = -n * read_size();   // -n values per row
+         if (is_type<V>(h.type)) {
+            read_data_append(c.values, n);
+         } else {
+            std::vector<V> w;
+            read_data_typed(h.type, w, n);
+            c.values.insert(c.values.end(), w.begin(), w.end());
+         }
+      }
+      if (c.stride == 0) c.offsets.push_back(c.values.size());
+      increase_actual_header();
+   }
+
+   // append n values read directly at the end of v
+   template<typename V>
+   void read_data_append(std::vector<V>& v, CMMFile_SIZETYPE n) {
+      size_t o = v.size();
+      v.resize(o + n);
+      if (n > 0) std::fstream::read((char *) &v[o], n * sizeof(V));
+   }
+
+
+#if __cplusplus >= 201103L
+public:
+/****************************************************************************************
+   typed sequences
+      sequence<Ts...> fixes the columns at compile time: V for scalars, std::vector<V> and
+      std::vector< std::vector<V> > for vectors and matrices of plain types,
+      the header sequence is checked once in read_header, records are then written and
+      read without checks of the types or walking the header sequence,
+      write_batch encodes many records into one buffer
+*****************************************************************************************/
+
+   template<typename... Ts>
+   class sequence {
+   public:
+      explicit sequence(CMMFile& f) : file(f) {}
+
+      // dims of the columns, empty or missing ones are -1 (variable size) for vectors,
+      // matrices need dim[1]
+      void write_header(const std::vector< std::vector<CMMFile_SIZETYPE> >& dims = std::vector< std::vector<CMMFile_SIZETYPE> >()) {
+         file.write_start_sequence();
+         size_t i = 0;
+         int unused[] = {0, (write_column_header<Ts>(i < dims.size() && !dims[i].empty() ? dims[i] : default_dim<Ts>(), i), i++, 0)...};
+         (void) unused;
+         file.write_end_sequence();
+      }
+
+      // columns of other types or coded ('X', 'V', 'P', ...) set failbit
+      void read_header() {
+         file.read_header_sequence();
+         bool ok = file.header_sequence.size() == sizeof...(Ts);
+         if (ok) {
+            size_t i = 0;
+            int unused[] = {0, (ok = check_column<Ts>(file.header_sequence[i], i) && ok, i++, 0)...};
+            (void) unused;
+         }
+         if (!ok) file.setstate(std::ios::failbit);
+      }
+
+      void write(const Ts&... v) {
+         size_t i = 0;
+         int unused[] = {0, (file.write_column(v, size[i], cols[i]), i++, 0)...};
+         (void) unused;
+      }
+
+      // n records given column wise, either as vectors of n values or arrays,
+      // encoded into one buffer that is written in blocks of about CMMFile_BUFFERSIZE bytes
+      void write_batch(const std::vector<Ts>&... c) {
+         size_t n[] = {c.size()...};
+         for (size_t i = 1; i < sizeof...(Ts); i++) assert(n[i] == n[0]);
+         write_records(n[0], c...);
+      }
+
+      void write_batch(size_t n, const Ts*... c) {
+         write_records(n, c...);
+      }
+
+      // false at the end of the file
+      bool read(Ts&... v) {
+         if (file.peek() == EOF) return false;
+         size_t i = 0;
+         int unused[] = {0, (file.read_column(v, size[i], cols[i]), i++, 0)...};
+         (void) unused;
+         return !file.fail();
+      }
+
+   private:
+      CMMFile& file;
+      CMMFile_SIZETYPE size[sizeof...(Ts) + 1];   // first dimension, -1 for variable size
+      CMMFile_SIZETYPE cols[sizeof...(Ts) + 1];   // second dimension of matrices
+      std::vector<char> buffer;                   // encoded records of write_batch
+
+      template<typename... Cs>
+      void write_records(size_t n, const Cs&... c) {
+         buffer.clear();
+         for (size_t k = 0; k < n; k++) {
+            size_t i = 0;
+            int unused[] = {0, (put_column(buffer, static_cast<const Ts&>(c[k]), size[i], cols[i]), i++, 0)...};
+            (void) unused;
+            if (buffer.size() >= CMMFile_BUFFERSIZE) {
+               file.std::fstream::write(&buffer[0], buffer.size());
+               buffer.clear();
+            }
+         }
+         if (!buffer.empty()) file.std::fstream::write(&buffer[0], buffer.size());
+      }
+
+      template<typename T>
+      static std::vector<CMMFile_SIZETYPE> default_dim() {
+         return std::vector<CMMFile_SIZETYPE>(column<T>::rank > 0 ? 1 : 0, -1);
+      }
+
+      template<typename T>
+      void write_column_header(const std::vector<CMMFile_SIZETYPE>& dim, size_t i) {
+         header h;
+         h.type = file.to_type<typename column<T>::value_type>();
+         h.dim = dim;
+         bool ok = check_column<T>(h, i);
+         assert(ok);
+         (void) ok;
+         file.write_header_sequence(h);
+      }
+
+      template<typename T>
+      bool check_column(const header& h, size_t i) {
+         size[i] = h.dim.size() > 0 ? h.dim[0] : 1;
+         cols[i] = h.dim.size() > 1 ? h.dim[1] : 1;
+         return h.type == file.to_type<typename column<T>::value_type>()
+             && h.dim.size() == size_t(column<T>::rank) && cols[i] >= 0;
+      }
+   };
+
+private:
+   // value type and rank of sequence columns
+   template<typename T> struct column { typedef T value_type; enum { rank = 0 }; };
+   template<typename V> struct column< std::vector<V> > { typedef V value_type; enum { rank = 1 }; };
+   template<typename V> struct column< std::vector< std::vector<V> > > { typedef V value_type; enum { rank = 2 }; };
+
+   template<typename V>
+   inline void write_column(const V& v, CMMFile_SIZETYPE, CMMFile_SIZETYPE) {
+      write_data(v);
+   }
+
+   template<typename V>
+   inline void write_column(const std::vector<V>& v, CMMFile_SIZETYPE size, CMMFile_SIZETYPE) {
+      if (size < 0) write_size(v.size());
+      else assert(CMMFile_SIZETYPE(v.size()) == size);
+      write_data(v);
+   }
+
+   template<typename V>
+   inline void write_column(const std::vector< std::vector<V> >& v, CMMFile_SIZETYPE size, CMMFile_SIZETYPE cols) {
+      if (size < 0) write_size(v.size());
+      else assert(CMMFile_SIZETYPE(v.size()) == size);
+      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(CMMFile_SIZETYPE(it->size()) == cols);
+         write_data(*it);
+      }
+   }
+
+   // columns appended to a buffer as write_column writes them
+   template<typename V>
+   static void put_column(std::vector<char>& b, const V& v, CMMFile_SIZETYPE, CMMFile_SIZETYPE) {
+      const char* c = (const char *) &v;
+      b.insert(b.end(), c, c + sizeof(V));
+   }
+
+   static void put_column(std::vector<char>& b, const bool& v, CMMFile_SIZETYPE, CMMFile_SIZETYPE) {
+      b.push_back(v ? CMMFile_TRUE : CMMFile_FALSE);
+   }
+
+   static void put_column(std::vector<char>& b, const std::string& v, CMMFile_SIZETYPE, CMMFile_SIZETYPE) {
+      b.insert(b.end(), v.c_str(), v.c_str() + strlen(v.c_str()) + 1);
+   }
+
+   template<typename V>
+   static void put_column(std::vector<char>& b, const std::vector<V>& v, CMMFile_SIZETYPE size, CMMFile_SIZETYPE cols) {
+      if (size < 0) put_column(b, CMMFile_SIZETYPE(v.size()), size, cols);
+      else assert(CMMFile_SIZETYPE(v.size()) == size);
+      put_values(b, v);
+   }
+
+   template<typename V>
+   static void put_column(std::vector<char>& b, const std::vector< std::vector<V> >& v, CMMFile_SIZETYPE size, CMMFile_SIZETYPE cols) {
+      if (size < 0) put_column(b, CMMFile_SIZETYPE(v.size()), size, cols);
+      else assert(CMMFile_SIZETYPE(v.size()) == size);
+      for (typename std::vector< std::vector<V> >::const_iterator it = v.begin(); it != v.end(); it++) {
+         assert(CMMFile_SIZETYPE(it->size()) == cols);
+         put_values(b, *it);
+      }
+   }
+
+   template<typename V>
+   static void put_values(std::vector<char>& b, const std::vector<V>& v) {
+      if (v.empty()) return;
+      const char* c = (const char *) &v[0];
+      b.insert(b.end(), c, c + v.size() * sizeof(V));
+   }
+
+   static void put_values(std::vector<char>& b, const std::vector<bool>& v) {
+      for (std::vector<bool>::const_iterator it = v.begin(); it != v.end(); it++) b.push_back(*it ? CMMFile_TRUE : CMMFile_FALSE);
+   }
+
+   static void put_values(std::vector<char>& b, const std::vector<std::string>& v) {
+      for (std::vector<std::string>::const_iterator it = v.begin(); it != v.end(); it++) put_column(b, *it, 0, 0);
+   }
+
+   template<typename V>
+   inline void read_column(V& v, CMMFile_SIZETYPE, CMMFile_SIZETYPE) {
+      read_data(v);
+   }
+
+   template<typename V>
+   inline void read_column(std::vector<V>& v, CMMFile_SIZETYPE size, CMMFile_SIZETYPE) {
+      read_data(v, size < 0 ? read_size() : size);
+   }
+
+   template<typename V>
+   inline void read_column(std::vector< std::vector<V> >& v, CMMFile_SIZETYPE size, CMMFile_SIZETYPE cols) {
+      read_data(v, size < 0 ? read_size() : size, cols);
+   }
+#endif
+
 
 public:
 /****************************************************************************************
@@ -846,8 +4337,7 @@ public:
    void skip() {
       header h;
       read_header(h);
-      CMMFile_SIZETYPE l=1;
-      assert(h.dim[0] >= 0); // skipping of last entry is nonsense
+      assert(h.dim.size() == 0 || h.dim[0] >= 0); // skipping of last entry is nonsense
       skip_data(h.type, length(h.dim));
    }
 
@@ -878,13 +4368,9 @@ public:
    //template <> void skip_data<const char*>(CMMFile_SIZETYPE n);
 
    void skip_string_data(CMMFile_SIZETYPE n) {
-      for(int i=0; i<n; i++) {
-         char c;
-         std::fstream::read((char *) &c, sizeof(char));
-         while ( c != '\0' && ! std::fstream::eof() )
-         {
-            std::fstream::read((char *) &c, sizeof(char));
-         }
+      // scans the stream buffer for the terminators instead of reading single characters
+      for(int i=0; i<n && !std::fstream::eof(); i++) {
+         std::fstream::ignore(std::numeric_limits<std::streamsize>::max(), '\0');
       }
    }
 
@@ -898,6 +4384,20 @@ public:
       if (type == CMMFile_TEXT)
       {
          skip_string_data(n);
+      } else if (type == CMMFile_PTXT) {
+         skip_prefixed_data(n);
+      } else if (type == CMMFile_DTXT) {
+         skip_dictionary_data(n);
+      } else if (type == CMMFile_BITS) {
+         skip_bits_data(n);
+      } else if (type == CMMFile_ZIPD) {
+         skip_compressed_data();
+      } else if (type == CMMFile_VINT) {
+         skip_varint_data();
+      } else if (type == CMMFile_TILE) {
+         skip_tiled_data();
+      } else if (type == CMMFile_QUANT) {
+         skip_quantized_data(n);
       } else {
          seekp(n*size_of(type), ios_base::cur);
       }
@@ -905,9 +4405,15 @@ public:
 
    // skip to last data entry
    void seek_last() {
+      if (has_index()) {
+         assert(index.size() > 0);
+         seekg(index.back().offset, std::ios_base::beg);
+         return;
+      }
+
       CMMFile_TYPETYPE type;
       std::vector<CMMFile_SIZETYPE> d;
-      streampos pos;
+      std::streampos pos;
       CMMFile_SIZETYPE s = 0;
 
       while (s!=-1 && !eof()) {
@@ -932,6 +4438,265 @@ public:
       assert(!eof());
    }
 
+   // scan entries from actual position to end of file, an open ended entry
+   // (sequence or first dimension -1) extends to the end of the file and is the last one
+   void scan_entries(std::vector<entry>& es) {
+      es.clear();
+      std::streamoff pos = tellg();
+      seekg(0, std::ios_base::end);
+      std::streamoff fend = has_index() ? index_offset : std::streamoff(tellg());
+      seekg(pos, std::ios_base::beg);
+
+      while (tellg() < fend && peek() != EOF) {
+         entry e;
+         e.offset = tellg();
+         if (peek() == CMMFile_SEQS) {
+            e.h.type = CMMFile_SEQS;
+            e.data = e.offset;
+            e.end = fend;
+         } else {
+            read_header(e.h);
+            e.data = tellg();
+            if (e.h.dim.size() > 0 && e.h.dim[0] == -1) {
+               e.end = fend;
+            } else {
+               skip_data(e.h.type, e.h.dim);
+               e.end = tellg();
+            }
+         }
+         es.push_back(e);
+         if (e.end == fend) break;
+      }
+      clear();
+      seekg(es.size() > 0 ? es.back().end : pos, std::ios_base::beg);
+   }
+
+
+public:
+/****************************************************************************************
+   index of entries
+      entries are recorded while they are written (a write_type followed by write_dim),
+      the index is written at close() if enabled and the file has no open ended entries
+      (sequence or -1 dimension), it is stored as two regular entries at the end of
+      the file so readers not knowing it see two more long long (CMMFile_INT64) arrays,
+      readers without the 'l' type cannot parse files with an index:
+         'l' m      {offset, type, data, end, dim, size_1 ... size_dim} for each entry
+         'l' 2      {offset of the index, CMMFile_INDEX_MAGIC}
+      open_write_append removes the index and writes it again at close()
+*****************************************************************************************/
+
+   // write an index when closing files opened for writing
+   void set_index(bool on) { index_on_close = on; }
+
+   // file contains an index, loaded on first use
+   bool has_index() {
+      if (!index_loaded) load_index();
+      return index_offset >= 0;
+   }
+
+   // number of entries, an open ended entry counts as one
+   CMMFile_SIZETYPE entry_count() {
+      if (has_index()) return index.size();
+      std::streamoff pos = tellg();
+      seekg(0, std::ios_base::beg);
+      std::vector<entry> es;
+      scan_entries(es);
+      seekg(pos, std::ios_base::beg);
+      return es.size();
+   }
+
+   // position stream at the header of entry n
+   void seek_entry(CMMFile_SIZETYPE n) {
+      assert(n >= 0);
+      if (has_index()) {
+         assert(n < CMMFile_SIZETYPE(index.size()));
+         seekg(index[n].offset, std::ios_base::beg);
+         return;
+      }
+      seekg(0, std::ios_base::beg);
+      skip(n);
+   }
+
+   // entry n, without index its dimensions are read from its header
+   entry get_entry(CMMFile_SIZETYPE n) {
+      seek_entry(n);
+      if (has_index()) return index[n];
+      entry e;
+      e.offset = tellg();
+      read_header(e.h);
+      e.data = tellg();
+      skip_data(e.h.type, e.h.dim);
+      e.end = tellg();
+      seekg(e.offset, std::ios_base::beg);
+      return e;
+   }
+
+private:
+   bool index_on_close;
+   bool index_loaded;
+   std::vector<entry> index;
+   std::streamoff index_offset;
+
+   // entries written so far, the last type written and whether its dimensions follow
+   std::vector<entry> written;
+   entry index_next;
+   bool index_pending;
+   bool index_open_ended;
+
+   inline void index_type(CMMFile_TYPETYPE type) {
+      index_next.offset = tellp();
+      index_next.h.type = type;
+      index_pending = true;
+      if (type == CMMFile_SEQS) index_open_ended = true;
+   }
+
+   inline void index_entry(const std::vector<CMMFile_SIZETYPE>& dim) {
+      index_pending = false;
+      if (dim.size() > 0 && dim[0] == -1) index_open_ended = true;
+      if (index_open_ended) return;
+      entry e = index_next;
+      e.h.dim = dim;
+      e.data = e.offset + sizeof(CMMFile_TYPETYPE) + sizeof(CMMFile_DIMTYPE) + dim.size() * sizeof(CMMFile_SIZETYPE);
+      e.end = -1;
+      written.push_back(e);
+   }
+
+   static bool truncate_file(const std::string& fn, std::streamoff size) {
+#ifdef CMMFile_POSIX
+      return ::truncate(fn.c_str(), size) == 0;
+#else
+      // copy the first size bytes to a temporary file that replaces fn
+      std::string tmp = fn + ".tmp";
+      std::ifstream in(fn.c_str(), std::ios::in | std::ios::binary);
+      std::ofstream out(tmp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      std::vector<char> b(CMMFile_BUFFERSIZE);
+      for (std::streamoff done = 0; done < size; ) {
+         std::streamsize k = std::streamsize(std::min<std::streamoff>(b.size(), size - done));
+         in.read(&b[0], k);
+         if (in.gcount() != k) return false;
+         out.write(&b[0], k);
+         done += k;
+      }
+      in.close();
+      out.close();
+      if (!out) return false;
+      return remove(fn.c_str()) == 0 && rename(tmp.c_str(), fn.c_str()) == 0;
+#endif
+   }
+
+   void load_index() {
+      index_loaded = true;
+      index.clear();
+      index_offset = -1;
+      if (!(io_mode & std::ios::in)) return;
+
+      std::streamoff pos = tellg();
+      seekg(0, std::ios_base::end);
+      std::streamoff fend = tellg();
+      const std::streamoff trailer = sizeof(CMMFile_TYPETYPE) + sizeof(CMMFile_DIMTYPE) + sizeof(CMMFile_SIZETYPE) + 2 * sizeof(long long);
+      if (fend >= trailer) {
+         seekg(fend - trailer, std::ios_base::beg);
+         long long off = -1, magic = 0;
+         if (read_type() == CMMFile_INT64 && read_dim() == 1 && read_size() == 2) {
+            read_data(off);
+            read_data(magic);
+         }
+         if (magic == CMMFile_INDEX_MAGIC && off >= 0 && off < fend) {
+            seekg(off, std::ios_base::beg);
+            std::vector<long long> d;
+            header h;
+            read_header(h);
+            if (h.type == CMMFile_INT64 && h.dim.size() == 1 && h.dim[0] >= 0) {
+               read_data(d, h.dim[0]);
+               size_t k = 0;
+               while (k + 5 <= d.size() && k + 5 + d[k+4] <= d.size()) {
+                  entry e;
+                  e.offset = d[k];
+                  e.h.type = CMMFile_TYPETYPE(d[k+1]);
+                  e.data = d[k+2];
+                  e.end = d[k+3];
+                  e.h.dim.assign(d.begin() + k + 5, d.begin() + k + 5 + d[k+4]);
+                  k += 5 + d[k+4];
+                  index.push_back(e);
+               }
+               index_offset = off;
+            }
+         }
+      }
+      clear();
+      seekg(pos, std::ios_base::beg);
+   }
+
+   void write_index() {
+      if (index_open_ended || written.empty()) return;
+      std::streamoff fend = tellp();
+      std::vector<long long> d;
+      for (size_t i = 0; i < written.size(); i++) {
+         const entry& e = written[i];
+         d.push_back(e.offset);
+         d.push_back(e.h.type);
+         d.push_back(e.data);
+         d.push_back(i + 1 < written.size() ? written[i+1].offset : fend);
+         d.push_back(e.h.dim.size());
+         d.insert(d.end(), e.h.dim.begin(), e.h.dim.end());
+      }
+      index_on_close = false;   // the index itself is no entry
+      write_header<long long>(d.size());
+      write_data(d);
+      write_header<long long>(2);
+      write_data((long long) fend);
+      write_data((long long) CMMFile_INDEX_MAGIC);
+      index_on_close = true;
+   }
+
+#ifdef CMMFile_THREADS
+public:
+/****************************************************************************************
+   parallel reading of all entries
+      one pass over the headers (or the index) gives the entries, worker threads
+      read (pread) and decode them concurrently into a list of values,
+      arrays are stored flat with their dimensions in the header
+*****************************************************************************************/
+
+   // decoded data entry, data<V>() with V the c++ type of the (decompressed) entry:
+   // double, int, long, unsigned long, the fixed width types (float, signed char, ...),
+   // std::string, bool or char for undecoded entries (sequences)
+   struct value {
+      header h;   // dimensions with -1 replaced by the actual size
+
+      template<typename V>
+      bool is() const { return dynamic_cast<const holder<V>*>(p.get()) != 0; }
+
+      template<typename V>
+      const std::vector<V>& data() const {
+         assert(is<V>());
+         return ((const holder<V>*) p.get())->v;
+      }
+
+      struct holder_base { virtual ~holder_base() {} };
+      template<typename V> struct holder : holder_base { std::vector<V> v; };
+      std::shared_ptr<holder_base> p;
+   };
+
+   // read all entries from the actual position, threads = 0 uses all cores,
+   // the stream is positioned after the last entry
+   void read_all_parallel(std::vector<value>& values, int threads = 0);
+
+private:
+   template<typename V>
+   static void decode_entry(CMMFile& d, value& v, CMMFile_SIZETYPE n) {
+      CMMFile::value::holder<V>* h = new CMMFile::value::holder<V>();
+      v.p.reset(h);
+      if (v.h.type == CMMFile_TILE) {
+         d.read_data_tiled(h->v, v.h.dim, CMMFile_tag<CMMFile_numeric<V>::value>());
+      } else {
+         d.read_data_typed(v.h.type, h->v, n);
+      }
+   }
+
+   static void decode_entry(const char* data, size_t size, value& v);
+#endif
+
 };
 
 
@@ -945,7 +4710,7 @@ template specializations
 
 template <>
 void CMMFile::tell_size<std::string>(CMMFile_SIZETYPE& size) {
-   streampos pos = tellp();
+   std::streampos pos = tellp();
    //search for null terminatons until end of file
    size = 0;
    char c;
@@ -964,9 +4729,9 @@ void CMMFile::tell_size<CMMFile::cstr_type>(CMMFile_SIZETYPE& size) {
 
 template <>
 void CMMFile::tell_size<bool>(CMMFile_SIZETYPE& size) {
-   streampos pos = tellg();
+   std::streampos pos = tellg();
    seekg(0, ios_base::end);
-   streampos end = tellg();
+   std::streampos end = tellg();
    seekg(pos, ios_base::beg);
    size = CMMFile_SIZETYPE((end-pos)/sizeof(char));
 }
@@ -1004,15 +4769,9 @@ inline void CMMFile::write_data<bool>(const bool& v)
 
 
 template<>
-inline void CMMFile::read_data<std::string>(std::string& v) {
-   v = "";
-   char c;
-   std::fstream::read((char *) &c, sizeof(char));
-   while ( c != '\0' && ! std::fstream::eof() )
-   {
-      v.append(&c, 1);
-      std::fstream::read((char *) &c, sizeof(char));
-   }
+inline void CMMFile::read_data<std::string>(std::string& v) {
+   // scans the stream buffer for the terminator instead of reading single characters
+   std::getline(*this, v, '\0');
 }
 
 template<>
@@ -1036,13 +4795,12 @@ inline void CMMFile::read_data<bool>(bool& v) {
 
 template<>
 inline void CMMFile::read_data<std::string, CMMFile_SIZETYPE>(std::vector<std::string>& v, const CMMFile_SIZETYPE& size) {
-   CMMFile_SIZETYPE s = size;
    if (size<0) {
-      v.clear();
-      std::string str;
-      while (!std::fstream::eof()) {
-         read_data<std::string>(str);
-         v.push_back(str);
+      string_list l;
+      read_data(l, size);
+      v.resize(l.size());
+      for (size_t i = 0; i < l.size(); i++) {
+         v[i].assign(l[i], l.length(i));
       }
    } else {
       v.resize(size);
@@ -1056,13 +4814,15 @@ inline void CMMFile::read_data<std::string, CMMFile_SIZETYPE>(std::vector<std::s
 template<>
 inline void CMMFile::read_data<std::string, CMMFile_SIZETYPE>
 (std::vector< std::vector<std::string> >& v, const CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
-   CMMFile_SIZETYPE s = size1;
    if (size1<0) {
-      v.clear();
-      while (!std::fstream::eof()) {
-         std::vector<std::string> vs;
-         read_data<std::string, CMMFile_SIZETYPE>(vs, size2);
-         v.push_back(vs);
+      string_list l;
+      read_data(l, size1);
+      v.resize(size2 > 0 ? l.size() / size2 : 0);
+      for (size_t i = 0; i < v.size(); i++) {
+         v[i].resize(size2);
+         for (CMMFile_SIZETYPE j = 0; j < size2; j++) {
+            v[i][j].assign(l[i * size2 + j], l.length(i * size2 + j));
+         }
       }
    } else {
       v.resize(size1);
@@ -1078,11 +4838,15 @@ template<>
 inline void CMMFile::read_data<bool, CMMFile_SIZETYPE>(std::vector<bool>& v, const CMMFile_SIZETYPE& size) {
    CMMFile_SIZETYPE s = size;
    if (size<0) { tell_size<bool>(s); }
-   v.clear();
-   bool b;
-   for (CMMFile_SIZETYPE i = 0; i<s; i++) {
-      read_data<bool>(b);
-      v.push_back(b);
+   v.resize(s);
+   // decode blocks of characters via bits
+   std::vector<char> c(std::min<CMMFile_SIZETYPE>(s, CMMFile_BUFFERSIZE));
+   std::vector<unsigned char> bits((c.size() + 7)/8);
+   for (CMMFile_SIZETYPE i = 0; i < s; i += c.size()) {
+      CMMFile_SIZETYPE n = std::min<CMMFile_SIZETYPE>(s - i, c.size());
+      std::fstream::read(&c[0], n);
+      pack_bools(&c[0], n, &bits[0]);
+      unpack_bools(&bits[0], n, v.begin() + i);
    }
 }
 
@@ -1107,42 +4871,152 @@ inline void CMMFile::read_data<bool, CMMFile_SIZETYPE>
 
 
 
+template<>
+inline void CMMFile::read_data_typed<std::string>(const CMMFile_TYPETYPE& t, std::string& v) {
+   if (t == CMMFile_PTXT) {
+      std::vector<std::string> vs;
+      read_data_prefixed(vs, 1);
+      v = vs[0];
+   } else {
+      assert(t == CMMFile_TEXT);
+      read_data<std::string>(v);
+   }
+}
+
+template<>
+inline void CMMFile::read_data_typed<std::string, CMMFile_SIZETYPE>
+(const CMMFile_TYPETYPE& t, std::vector<std::string>& v, const CMMFile_SIZETYPE& size) {
+   if (t == CMMFile_PTXT) {
+      read_data_prefixed(v, size);
+   } else if (t == CMMFile_DTXT) {
+      read_data_dictionary(v, size);
+   } else {
+      assert(t == CMMFile_TEXT);
+      read_data<std::string, CMMFile_SIZETYPE>(v, size);
+   }
+}
+
+template<>
+inline void CMMFile::read_data_typed<std::string, CMMFile_SIZETYPE>
+(const CMMFile_TYPETYPE& t, std::vector< std::vector<std::string> >& v, const CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
+   if (t == CMMFile_PTXT) {
+      read_data_prefixed(v, size1, size2);
+   } else if (t == CMMFile_DTXT) {
+      read_data_dictionary(v, size1, size2);
+   } else {
+      assert(t == CMMFile_TEXT);
+      read_data<std::string, CMMFile_SIZETYPE>(v, size1, size2);
+   }
+}
+
+
+template<>
+inline void CMMFile::read_data_typed<bool>(const CMMFile_TYPETYPE& t, bool& v) {
+   if (t == CMMFile_BITS) {
+      read_data_bits(v);
+   } else {
+      assert(t == CMMFile_BOOL);
+      read_data<bool>(v);
+   }
+}
+
+template<>
+inline void CMMFile::read_data_typed<bool, CMMFile_SIZETYPE>
+(const CMMFile_TYPETYPE& t, std::vector<bool>& v, const CMMFile_SIZETYPE& size) {
+   if (t == CMMFile_BITS) {
+      read_data_bits(v, size);
+   } else {
+      assert(t == CMMFile_BOOL);
+      read_data<bool, CMMFile_SIZETYPE>(v, size);
+   }
+}
+
+template<>
+inline void CMMFile::read_data_typed<bool, CMMFile_SIZETYPE>
+(const CMMFile_TYPETYPE& t, std::vector< std::vector<bool> >& v, const CMMFile_SIZETYPE& size1, const CMMFile_SIZETYPE& size2) {
+   if (t == CMMFile_BITS) {
+      read_data_bits(v, size1, size2);
+   } else {
+      assert(t == CMMFile_BOOL);
+      read_data<bool, CMMFile_SIZETYPE>(v, size1, size2);
+   }
+}
+
+
 template<>
 inline void CMMFile::write_data<std::string>(const std::vector<std::string>& v) {
+   // gather into one write
+   size_t n = 0;
+   for (std::vector<std::string>::const_iterator it = v.begin(); it != v.end(); it++) {
+      n += it->size() + 1;
+   }
+   std::string blob;
+   blob.reserve(n);
    for (std::vector<std::string>::const_iterator it = v.begin(); it != v.end(); it++) {
-      write_data<std::string>(*it);
+      blob.append(it->c_str(), strlen(it->c_str()) + 1);
    }
+   std::fstream::write(blob.data(), blob.size());
 }
 
 template<>
 inline void CMMFile::write_data<bool>(const std::vector<bool>& v) {
-   for (std::vector<bool>::const_iterator it = v.begin(); it != v.end(); it++) {
-      write_data<bool>(*it);
+   // encode blocks of characters via bits
+   std::vector<char> c(std::min<size_t>(v.size(), CMMFile_BUFFERSIZE));
+   std::vector<unsigned char> bits((c.size() + 7)/8);
+   for (size_t i = 0; i < v.size(); i += c.size()) {
+      size_t n = std::min(v.size() - i, c.size());
+      pack_bools(v.begin() + i, n, &bits[0]);
+      unpack_bools(&bits[0], n, &c[0]);
+      std::fstream::write(&c[0], n);
    }
 }
 
 
 template<>
 inline void CMMFile::write_data<std::string>(const std::vector< std::vector<std::string> >& v) {
-   CMMFile_SIZETYPE size = v[0].size();
+   CMMFile_SIZETYPE size = v.empty() ? 0 : v[0].size();
+   size_t n = 0;
    for (std::vector< std::vector<std::string> >::const_iterator it = v.begin(); it != v.end(); it++) {
       assert(size == it->size());
+      for (std::vector<std::string>::const_iterator iit = it->begin(); iit != it->end(); iit++) {
+         n += iit->size() + 1;
+      }
    }
+   std::string blob;
+   blob.reserve(n);
    for (std::vector< std::vector<std::string> >::const_iterator it = v.begin(); it != v.end(); it++) {
-      write_data<std::string>(*it);
+      for (std::vector<std::string>::const_iterator iit = it->begin(); iit != it->end(); iit++) {
+         blob.append(iit->c_str(), strlen(iit->c_str()) + 1);
+      }
    }
+   std::fstream::write(blob.data(), blob.size());
 }
 
 template<>
 inline void CMMFile::write_data<bool>(const std::vector< std::vector<bool> >& v) {
-   assert(v.size()>0);
-   CMMFile_SIZETYPE size = v[0].size();
+   CMMFile_SIZETYPE size = v.empty() ? 0 : v[0].size();
+   std::vector<bool> flat;
+   flat.reserve(v.size() * size);
    for (std::vector< std::vector<bool> >::const_iterator it = v.begin(); it != v.end(); it++) {
       assert(size == it->size());
+      flat.insert(flat.end(), it->begin(), it->end());
    }
-   for (std::vector< std::vector<bool> >::const_iterator it = v.begin(); it != v.end(); it++) {
-      write_data<bool>(*it);
-   }
+   write_data<bool>(flat);
+}
+
+
+template<>
+inline void CMMFile::read_data_append<std::string>(std::vector<std::string>& v, CMMFile_SIZETYPE n) {
+   std::vector<std::string> w;
+   read_data(w, n);
+   v.insert(v.end(), w.begin(), w.end());
+}
+
+template<>
+inline void CMMFile::read_data_append<bool>(std::vector<bool>& v, CMMFile_SIZETYPE n) {
+   std::vector<bool> w;
+   read_data(w, n);
+   v.insert(v.end(), w.begin(), w.end());
 }
 
 
@@ -1172,6 +5046,22 @@ inline CMMFile_TYPETYPE CMMFile::to_type<long>()          { return CMMFile_LONG;
 template<>
 inline CMMFile_TYPETYPE CMMFile::to_type<unsigned long>() { return CMMFile_ULNG; }
 template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<float>()              { return CMMFile_FLT32; }
+template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<signed char>()        { return CMMFile_INT8; }
+template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<short>()              { return CMMFile_INT16; }
+template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<long long>()          { return CMMFile_INT64; }
+template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<unsigned char>()      { return CMMFile_UINT8; }
+template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<unsigned short>()     { return CMMFile_UINT16; }
+template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<unsigned int>()       { return CMMFile_UINT32; }
+template<>
+inline CMMFile_TYPETYPE CMMFile::to_type<unsigned long long>() { return CMMFile_UINT64; }
+template<>
 inline CMMFile_TYPETYPE CMMFile::to_type<std::string>()   { return CMMFile_TEXT; }
 template<>
 inline CMMFile_TYPETYPE CMMFile::to_type<const char*>()   { return CMMFile_TEXT; }
@@ -1180,6 +5070,729 @@ inline CMMFile_TYPETYPE CMMFile::to_type<bool>()          { return CMMFile_BOOL;
 
 
 
+#ifdef CMMFile_THREADS
+/****************************************************************************************
+   parallel reading of all entries
+*****************************************************************************************/
+
+inline void CMMFile::decode_entry(const char* data, size_t size, value& v) {
+   CMMFile d;
+   d.set_compression(d.compression_chunk, 1);   // entries are already decoded in parallel
+   d.open_read_memory(data, size);
+   if (size > 0 && data[0] == CMMFile_SEQS) {
+      v.h.type = CMMFile_SEQS;
+      v.h.dim.clear();
+   } else {
+      d.read_header(v.h);
+   }
+   CMMFile_SIZETYPE n = d.length(v.h.dim);
+   if (v.h.dim.size() > 0 && v.h.dim[0] == -1) n = -1;
+
+   // compressed data is decoded to the type of its values
+   CMMFile_TYPETYPE t = v.h.type;
+   if (t == CMMFile_ZIPD || t == CMMFile_TILE) t = d.peek();
+   if (t == CMMFile_VINT) t = CMMFile_LONG;
+   if (t == CMMFile_HALF || t == CMMFile_BF16 || t == CMMFile_QUANT) t = CMMFile_REAL;
+
+   switch (t) {
+      case CMMFile_REAL: decode_entry<double>(d, v, n); break;
+      case CMMFile_INTG: decode_entry<int>(d, v, n); break;
+      case CMMFile_LONG: decode_entry<long>(d, v, n); break;
+      case CMMFile_ULNG: decode_entry<unsigned long>(d, v, n); break;
+      case CMMFile_FLT32:  decode_entry<float>(d, v, n); break;
+      case CMMFile_INT8:   decode_entry<signed char>(d, v, n); break;
+      case CMMFile_INT16:  decode_entry<short>(d, v, n); break;
+      case CMMFile_INT64:  decode_entry<long long>(d, v, n); break;
+      case CMMFile_UINT8:  decode_entry<unsigned char>(d, v, n); break;
+      case CMMFile_UINT16: decode_entry<unsigned short>(d, v, n); break;
+      case CMMFile_UINT32: decode_entry<unsigned int>(d, v, n); break;
+      case CMMFile_UINT64: decode_entry<unsigned long long>(d, v, n); break;
+      case CMMFile_TEXT:
+      case CMMFile_PTXT:
+      case CMMFile_DTXT: decode_entry<std::string>(d, v, n); break;
+      case CMMFile_BOOL:
+      case CMMFile_BITS: decode_entry<bool>(d, v, n); break;
+      default: {
+         // sequences and unknown encodings, keep the data
+         CMMFile::value::holder<char>* h = new CMMFile::value::holder<char>();
+         v.p.reset(h);
+         CMMFile_SIZETYPE r;
+         d.tell_size<char>(r);
+         d.read_data(h->v, r);
+         v.h.dim.assign(1, r);
+         return;
+      }
+   }
+
+   if (n < 0) {
+      CMMFile_SIZETYPE m = 1;
+      for (size_t i = 1; i < v.h.dim.size(); i++) m *= v.h.dim[i];
+      CMMFile_SIZETYPE k;
+      if (v.is<double>())                  k = v.data<double>().size();
+      else if (v.is<int>())                k = v.data<int>().size();
+      else if (v.is<long>())               k = v.data<long>().size();
+      else if (v.is<unsigned long>())      k = v.data<unsigned long>().size();
+      else if (v.is<float>())              k = v.data<float>().size();
+      else if (v.is<signed char>())        k = v.data<signed char>().size();
+      else if (v.is<short>())              k = v.data<short>().size();
+      else if (v.is<long long>())          k = v.data<long long>().size();
+      else if (v.is<unsigned char>())      k = v.data<unsigned char>().size();
+      else if (v.is<unsigned short>())     k = v.data<unsigned short>().size();
+      else if (v.is<unsigned int>())       k = v.data<unsigned int>().size();
+      else if (v.is<unsigned long long>()) k = v.data<unsigned long long>().size();
+      else if (v.is<std::string>())        k = v.data<std::string>().size();
+      else                                 k = v.data<bool>().size();
+      v.h.dim[0] = k / m;
+   }
+   v.h.type = t;
+}
+
+inline void CMMFile::read_all_parallel(std::vector<value>& values, int threads) {
+   std::vector<entry> es;
+   std::streamoff pos = tellg();
+   if (has_index()) {
+      for (size_t i = 0; i < index.size(); i++) {
+         if (index[i].offset >= pos) es.push_back(index[i]);
+      }
+      seekg(index_offset, std::ios_base::beg);
+   } else {
+      scan_entries(es);
+   }
+
+   values.clear();
+   values.resize(es.size());
+   if (es.size() == 0) return;
+
+   // memory backends are decoded in place, files are read with pread by each worker
+   CMMFile_membuf* m = memory();
+   int fd = -1;
+   if (m) {
+      for (size_t k = 0; k < es.size(); k++) {
+         if (es[k].end > std::streamoff(m->size())) {
+            setstate(std::ios::failbit);
+            return;
+         }
+      }
+   } else {
+      fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+         setstate(std::ios::failbit);
+         return;
+      }
+   }
+
+   if (threads <= 0) threads = std::thread::hardware_concurrency();
+   if (threads <= 0) threads = 1;
+   if (size_t(threads) > es.size()) threads = es.size();
+
+   std::mutex mutex;
+   size_t next = 0;
+   bool failed = false;
+
+   struct worker {
+      static void run(int fd, const char* data, const std::vector<entry>* es, std::vector<value>* values,
+                      std::mutex* mutex, size_t* next, bool* failed) {
+         std::vector<char> buffer;
+         while (true) {
+            size_t k;
+            {
+               std::lock_guard<std::mutex> lock(*mutex);
+               if (*next >= es->size() || *failed) return;
+               k = (*next)++;
+            }
+            const entry& e = (*es)[k];
+            if (data) {
+               decode_entry(data + e.offset, e.end - e.offset, (*values)[k]);
+               continue;
+            }
+            buffer.resize(e.end - e.offset);
+            size_t done = 0;
+            while (done < buffer.size()) {
+               ssize_t r = ::pread(fd, &buffer[done], buffer.size() - done, e.offset + done);
+               if (r < 0 && errno == EINTR) continue;
+               if (r <= 0) break;
+               done += r;
+            }
+            if (done != buffer.size()) {
+               std::lock_guard<std::mutex> lock(*mutex);
+               *failed = true;
+               return;
+            }
+            decode_entry(buffer.empty() ? 0 : &buffer[0], done, (*values)[k]);
+         }
+      }
+   };
+
+   std::vector<std::thread> pool;
+   for (int i = 0; i < threads; i++) {
+      pool.push_back(std::thread(&worker::run, fd, m ? m->data() : (const char*) 0, &es, &values, &mutex, &next, &failed));
+   }
+   for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+   if (fd >= 0) ::close(fd);
+   if (failed) setstate(std::ios::failbit);
+}
+#endif
+
+
+
+
+#ifdef CMMFile_THREADS
+/****************************************************************************************
+   asynchronous prefetching of data entries
+      headers are scanned once, the data of the next depth entries is read
+      in the background via io_uring or, if not available, a pool of threads using pread
+      so decoding entry n overlaps reading of entries n+1...n+depth
+
+      CMMFile_prefetch pf(cmm, depth);   // cmm is left at the end of the scanned entries
+      pf >> v1 >> v2;                    // or pf.next() >> v1;
+*****************************************************************************************/
+
+class CMMFile_prefetch {
+public:
+   CMMFile_prefetch(CMMFile& cmm, int depth = 8, int threads = 4) 
+      : fd(-1), actual(-1), slots(depth > 0 ? depth : 1), stop(false)
+   {
+      cmm.scan_entries(entries);
+      fd = ::open(cmm.filename.c_str(), O_RDONLY);
+      assert(fd >= 0);
+#ifdef CMMFile_IO_URING
+      if (!ring.setup(slots.size())) 
+#endif
+      {
+         for (int i = 0; i < (threads > 0 ? threads : 1); i++) {
+            workers.push_back(std::thread(&CMMFile_prefetch::work, this));
+         }
+      }
+      for (size_t k = 0; k < slots.size() && k < entries.size(); k++) submit(k);
+   }
+
+   ~CMMFile_prefetch()
+   {
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         stop = true;
+         queue.clear();
+      }
+      wakeup.notify_all();
+      for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+#ifdef CMMFile_IO_URING
+      ring.release();
+#endif
+      decoder.close();
+      if (fd >= 0) ::close(fd);
+   }
+
+   // number of entries
+   size_t size() const { return entries.size(); }
+
+   // all entries have been handed out
+   bool eof() const { return actual + 1 >= int(entries.size()); }
+
+   bool using_io_uring() const { return workers.size() == 0; }
+
+   const std::vector<CMMFile::entry>& entry_list() const { return entries; }
+
+   // stream positioned at the next entry, valid until the following call of next
+   CMMFile& next()
+   {
+      assert(!eof());
+      decoder.close();
+      if (actual >= 0 && actual + int(slots.size()) < int(entries.size())) {
+         submit(actual + slots.size());
+      }
+      actual++;
+      slot& s = slots[actual % slots.size()];
+      wait(s);
+      decoder.open_read_memory(s.data.empty() ? 0 : &s.data[0], s.done);
+      return decoder;
+   }
+
+   template<typename V>
+   CMMFile_prefetch& operator >> (V& v) {
+      next() >> v;
+      return *this;
+   }
+
+private:
+   struct slot {
+      std::vector<char> data;
+      off_t offset;
+      size_t done;
+      bool ready;
+   };
+
+   std::vector<CMMFile::entry> entries;
+   int fd;
+   int actual;
+   std::vector<slot> slots;
+   CMMFile decoder;
+
+   // thread pool
+   std::vector<std::thread> workers;
+   std::deque<slot*> queue;
+   std::mutex mutex;
+   std::condition_variable wakeup, finished;
+   bool stop;
+
+   void submit(size_t k)
+   {
+      slot& s = slots[k % slots.size()];
+      const CMMFile::entry& e = entries[k];
+      s.data.resize(e.end - e.offset);
+      s.offset = e.offset;
+      s.done = 0;
+      s.ready = false;
+#ifdef CMMFile_IO_URING
+      if (workers.size() == 0) {
+         if (!ring.submit(s, fd)) { read_slot(s, fd); s.ready = true; }
+         return;
+      }
+#endif
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         queue.push_back(&s);
+      }
+      wakeup.notify_one();
+   }
+
+   void wait(slot& s)
+   {
+#ifdef CMMFile_IO_URING
+      if (workers.size() == 0) {
+         while (!s.ready) {
+            if (!ring.complete(fd)) { read_slot(s, fd); s.ready = true; }
+         }
+         return;
+      }
+#endif
+      std::unique_lock<std::mutex> lock(mutex);
+      while (!s.ready) finished.wait(lock);
+   }
+
+   static void read_slot(slot& s, int file)
+   {
+      while (s.done < s.data.size()) {
+         ssize_t r = ::pread(file, &s.data[s.done], s.data.size() - s.done, s.offset + s.done);
+         if (r < 0 && errno == EINTR) continue;
+         if (r <= 0) break;
+         s.done += r;
+      }
+   }
+
+   void work()
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+         while (!stop && queue.empty()) wakeup.wait(lock);
+         if (stop) return;
+         slot* s = queue.front();
+         queue.pop_front();
+         lock.unlock();
+         read_slot(*s, fd);
+         lock.lock();
+         s->ready = true;
+         finished.notify_all();
+      }
+   }
+
+#ifdef CMMFile_IO_URING
+   // minimal io_uring using the raw system calls
+   struct uring {
+      int fd;
+      unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+      unsigned *cq_head, *cq_tail, *cq_mask;
+      struct io_uring_sqe* sqes;
+      struct io_uring_cqe* cqes;
+      void *sq_ptr, *cq_ptr;
+      size_t sq_size, cq_size, sqes_size;
+      unsigned pending;
+
+      uring() : fd(-1), pending(0) {}
+
+      bool setup(unsigned entries)
+      {
+         struct io_uring_params p;
+         memset(&p, 0, sizeof(p));
+         fd = syscall(__NR_io_uring_setup, entries, &p);
+         if (fd < 0) return false;
+
+         sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+         cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+         if (p.features & IORING_FEAT_SINGLE_MMAP) sq_size = cq_size = std::max(sq_size, cq_size);
+         sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+         sq_ptr = mmap(0, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+         cq_ptr = (p.features & IORING_FEAT_SINGLE_MMAP) ? sq_ptr :
+                  mmap(0, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+         sqes = (struct io_uring_sqe*) mmap(0, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+         if (sq_ptr == MAP_FAILED || cq_ptr == MAP_FAILED || sqes == MAP_FAILED) { 
+            ::close(fd); fd = -1;
+            return false;
+         }
+
+         sq_head  = (unsigned *) ((char *) sq_ptr + p.sq_off.head);
+         sq_tail  = (unsigned *) ((char *) sq_ptr + p.sq_off.tail);
+         sq_mask  = (unsigned *) ((char *) sq_ptr + p.sq_off.ring_mask);
+         sq_array = (unsigned *) ((char *) sq_ptr + p.sq_off.array);
+         cq_head  = (unsigned *) ((char *) cq_ptr + p.cq_off.head);
+         cq_tail  = (unsigned *) ((char *) cq_ptr + p.cq_off.tail);
+         cq_mask  = (unsigned *) ((char *) cq_ptr + p.cq_off.ring_mask);
+         cqes = (struct io_uring_cqe*) ((char *) cq_ptr + p.cq_off.cqes);
+         return true;
+      }
+
+      // wait for outstanding reads before unmapping the ring
+      void release()
+      {
+         if (fd < 0) return;
+         while (pending > 0 && complete(-1)) {}
+         munmap(sqes, sqes_size);
+         if (cq_ptr != sq_ptr) munmap(cq_ptr, cq_size);
+         munmap(sq_ptr, sq_size);
+         ::close(fd);
+         fd = -1;
+      }
+
+      // queue read of the remaining part of slot s
+      bool submit(slot& s, int file)
+      {
+         unsigned tail = *sq_tail;
+         unsigned idx = tail & *sq_mask;
+         struct io_uring_sqe* sqe = &sqes[idx];
+         memset(sqe, 0, sizeof(*sqe));
+         sqe->opcode = IORING_OP_READ;
+         sqe->fd = file;
+         sqe->addr = (unsigned long) (s.data.empty() ? 0 : &s.data[s.done]);
+         sqe->len = (unsigned) std::min<size_t>(s.data.size() - s.done, 1u << 30);
+         sqe->off = s.offset + s.done;
+         sqe->user_data = (unsigned long) &s;
+         sq_array[idx] = idx;
+         __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+         if (syscall(__NR_io_uring_enter, fd, 1, 0, 0, NULL, 0) != 1) {
+            __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+            return false;
+         }
+         pending++;
+         return true;
+      }
+
+      // wait for at least one completion, short reads are resubmitted
+      bool complete(int file)
+      {
+         if (pending == 0) return false;
+         if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) return false;
+         unsigned head = *cq_head;
+         while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe* cqe = &cqes[head & *cq_mask];
+            slot& s = *(slot *) cqe->user_data;
+            int res = cqe->res;
+            head++;
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+            pending--;
+            if (res > 0) s.done += res;
+            if (file < 0) continue;
+            if (res > 0 && s.done < s.data.size() && submit(s, file)) continue;
+            if (res < 0) read_slot(s, file);   // e.g. read not supported by kernel
+            s.ready = true;
+         }
+         return true;
+      }
+   } ring;
+#endif
+};
+#endif
+
+
+
+#if defined(CMMFile_POSIX) && __cplusplus >= 201103L
+/****************************************************************************************
+   following a file that is still written
+      the last entry of the file, a -1 stream or a sequence, is found once, poll then
+      appends only the whole values or records written since the last call, reading only
+      the new bytes, entries before it must be of plain types,
+      wait blocks until the file grows (inotify on linux, otherwise polling),
+      the writer has to flush to make data visible
+
+      CMMFile_follow fl(filename);
+      std::vector<double> v;             // -1 stream of doubles
+      while (fl.wait(1000)) fl.poll(v);
+      CMMFile_column<int> c1; ...        // sequence, see CMMFile::read_columns
+      while (fl.wait(1000)) fl.poll(c1, c2);
+*****************************************************************************************/
+
+class CMMFile_follow {
+public:
+   CMMFile_follow(const std::string& fn)
+      : fd(-1), notify(-1), found(false), sequence(false), pos(0), seen(0)
+   {
+      fd = ::open(fn.c_str(), O_RDONLY);
+#ifdef __linux__
+      notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+      if (notify >= 0 && inotify_add_watch(notify, fn.c_str(), IN_MODIFY | IN_CLOSE_WRITE) < 0) {
+         ::close(notify);
+         notify = -1;
+      }
+#endif
+   }
+
+   ~CMMFile_follow()
+   {
+      if (notify >= 0) ::close(notify);
+      if (fd >= 0) ::close(fd);
+   }
+
+   bool is_open() const { return fd >= 0; }
+
+   // header of the followed entry is complete
+   bool ready() { return found || find_header(); }
+
+   bool is_sequence() const { return sequence; }
+   const CMMFile::header& stream_header() const { return h; }
+   const CMMFile::header_sequence_type& record_headers() const { return hs; }
+
+   // bytes of the file consumed so far
+   off_t offset() const { return pos; }
+
+   // append the new whole values (rows for more dimensions) of the -1 stream, returns their number
+   template<typename V>
+   size_t poll(std::vector<V>& v)
+   {
+      CMMFile_STATIC_ASSERT(CMMFile_numeric<V>::value, "poll reads numbers of fixed size");
+      if (!ready()) return 0;
+      if (sequence || !decoder.is_type<V>(h.type)) {
+         assert(!"poll needs a stream of V");
+         return 0;
+      }
+      size_t rest = 1;
+      for (size_t d = 1; d < h.dim.size(); d++) rest *= h.dim[d];
+      size_t row = rest * decoder.size_of(h.type);
+      off_t size = seen = file_size();
+      if (row == 0 || size <= pos) return 0;
+      size_t n = size_t(size - pos) / row;
+      if (n == 0) return 0;
+      size_t o = v.size();
+      v.resize(o + n * rest);
+      if (!read_all(&v[o], n * row, pos)) {
+         v.resize(o);
+         return 0;
+      }
+      pos += n * row;
+      return n * rest;
+   }
+
+   // append the new whole records of the sequence to the columns, returns their number
+   template<typename... Ts>
+   size_t poll(CMMFile_column<Ts>&... c)
+   {
+      if (!ready()) return 0;
+      assert(sequence && hs.size() == sizeof...(Ts));
+      off_t size = seen = file_size();
+      size_t have = pending.size();
+      if (size > pos + off_t(have)) {
+         pending.resize(size - pos);
+         if (!read_all(&pending[have], pending.size() - have, pos + have)) pending.resize(have);
+      }
+
+      size_t used = 0, n = 0, r;
+      while (used < pending.size() && (r = record_size(&pending[used], pending.size() - used)) > 0) {
+         used += r;
+         n++;
+      }
+      if (n == 0) return 0;
+
+      decoder.open_read_memory(&pending[0], used);
+      decoder.header_sequence = hs;
+      decoder.actual_header = decoder.header_sequence.begin();
+      size_t i = 0;
+      int unused[] = {0, (init(c, hs[i++]), 0)...};
+      (void) unused;
+      for (size_t k = 0; k < n; k++) {
+         int record[] = {0, (decoder.read_column_record(c), 0)...};
+         (void) record;
+      }
+      hs = decoder.header_sequence;   // state of xor coded columns
+      decoder.close();
+
+      pending.erase(pending.begin(), pending.begin() + used);
+      pos += used;
+      return n;
+   }
+
+   // wait at most timeout ms (< 0 forever) for new bytes, false on timeout
+   bool wait(int timeout = -1)
+   {
+      long long end = now() + timeout;
+      while (!grown()) {
+         long long left = end - now();
+         if (timeout >= 0 && left <= 0) return false;
+         int slice = timeout >= 0 && left < 10 ? int(left) : 10;
+#ifdef __linux__
+         if (notify >= 0) {
+            // events of bytes already seen only lead to another look at the size
+            struct pollfd p = { notify, POLLIN, 0 };
+            if (::poll(&p, 1, timeout < 0 ? -1 : int(left)) > 0) {
+               char events[4096];
+               while (::read(notify, events, sizeof(events)) > 0) {}
+            }
+            continue;
+         }
+#endif
+         usleep(1000 * slice);
+      }
+      return true;
+   }
+
+private:
+   int fd, notify;
+   bool found, sequence;
+   off_t pos;                           // start of the first value / record not handed out
+   off_t seen;                          // file size at the last look
+   CMMFile::header h;                   // header of the -1 stream
+   CMMFile::header_sequence_type hs;    // headers of the sequence
+   std::vector<char> pending;           // bytes after pos read but not handed out
+   CMMFile decoder;
+
+   off_t file_size()
+   {
+      struct stat st;
+      return fstat(fd, &st) == 0 ? st.st_size : 0;
+   }
+
+   bool grown() { return fd >= 0 && file_size() > seen; }
+
+   static long long now()
+   {
+      struct timespec t;
+      clock_gettime(CLOCK_MONOTONIC, &t);
+      return t.tv_sec * 1000LL + t.tv_nsec / 1000000;
+   }
+
+   bool read_all(void* data, size_t n, off_t off)
+   {
+      char* d = (char *) data;
+      while (n > 0) {
+         ssize_t r = pread(fd, d, n, off);
+         if (r < 0 && errno == EINTR) continue;
+         if (r <= 0) return false;
+         d += r;
+         n -= r;
+         off += r;
+      }
+      return true;
+   }
+
+   bool get(off_t& off, size_t n, void* data, off_t size)
+   {
+      if (off + off_t(n) > size || !read_all(data, n, off)) return false;
+      off += n;
+      return true;
+   }
+
+   bool get_header(off_t& off, CMMFile::header& e, off_t size)
+   {
+      CMMFile_DIMTYPE dim;
+      if (!get(off, sizeof(CMMFile_TYPETYPE), &e.type, size)) return false;
+      if (!get(off, sizeof(CMMFile_DIMTYPE), &dim, size)) return false;
+      e.dim.resize(dim);
+      return dim == 0 || get(off, dim * sizeof(CMMFile_SIZETYPE), &e.dim[0], size);
+   }
+
+   // skips complete entries before the followed one, pos is left at its data
+   bool find_header()
+   {
+      if (fd < 0) return false;
+      off_t size = seen = file_size();
+      while (true) {
+         off_t off = pos;
+         CMMFile_TYPETYPE t;
+         if (!get(off, sizeof(CMMFile_TYPETYPE), &t, size)) return false;
+         if (t == CMMFile_SEQS) {
+            CMMFile::header_sequence_type list;
+            while (true) {
+               off_t q = off;
+               if (!get(q, sizeof(CMMFile_TYPETYPE), &t, size)) return false;
+               if (t == CMMFile_SEQE) {
+                  off = q;
+                  break;
+               }
+               CMMFile::header e;
+               if (!get_header(off, e, size)) return false;
+               list.push_back(e);
+            }
+            hs = list;
+            sequence = found = true;
+            pos = off;
+            return true;
+         }
+         off = pos;
+         CMMFile::header e;
+         if (!get_header(off, e, size)) return false;
+         if (e.dim.size() > 0 && e.dim[0] == -1) {
+            h = e;
+            found = true;
+            pos = off;
+            return true;
+         }
+         off_t n = 1;
+         for (size_t d = 0; d < e.dim.size(); d++) n *= e.dim[d];
+         n *= decoder.size_of(e.type);
+         if (off + n > size) return false;
+         pos = off + n;
+      }
+   }
+
+   // bytes of the whole record at p, 0 if not complete
+   size_t record_size(const char* p, size_t n)
+   {
+      size_t o = 0;
+      for (CMMFile::header_sequence_type::const_iterator it = hs.begin(); it != hs.end(); it++) {
+         if (it->type == CMMFile_XREL) {
+            if (o >= n) return 0;
+            unsigned char c = p[o];
+            o += 1 + 8 - ((c >> 3) & 0xf) - (c & 0x7);
+            continue;
+         }
+         size_t len = 1;
+         for (size_t d = 0; d < it->dim.size(); d++) {
+            if (it->dim[d] >= 0) {
+               len *= it->dim[d];
+               continue;
+            }
+            CMMFile_SIZETYPE s;
+            if (o + sizeof(CMMFile_SIZETYPE) > n) return 0;
+            memcpy(&s, p + o, sizeof(CMMFile_SIZETYPE));
+            o += sizeof(CMMFile_SIZETYPE);
+            len *= s;
+         }
+         if (it->type == CMMFile_TEXT) {
+            for (size_t k = 0; k < len; k++) {
+               const char* z = o < n ? (const char *) memchr(p + o, '\0', n - o) : 0;
+               if (!z) return 0;
+               o = z - p + 1;
+            }
+         } else if (it->type == CMMFile_VINT) {
+            CMMFile_OFFSETTYPE nb;
+            if (o + sizeof(CMMFile_OFFSETTYPE) > n) return 0;
+            memcpy(&nb, p + o, sizeof(CMMFile_OFFSETTYPE));
+            o += sizeof(CMMFile_OFFSETTYPE) + nb;
+         } else {
+            o += len * decoder.size_of(it->type);
+         }
+         if (o > n) return 0;
+      }
+      return o <= n ? o : 0;
+   }
+
+   template<typename V>
+   void init(CMMFile_column<V>& c, const CMMFile::header& e)
+   {
+      if (c.values.empty() && c.offsets.empty()) decoder.init_column(c, e);
+   }
+};
+#endif
+
+
+
 #endif
 
 
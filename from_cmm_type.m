@@ -6,10 +6,38 @@ function c = from_cmm_type(type)
           c = 'int32';
        case 'L'
           c = 'int64';
+       case 'U'
+          c = 'uint64';
+       case 'F'
+          c = 'single';
+       case 'c'
+          c = 'int8';
+       case 's'
+          c = 'int16';
+       case 'l'
+          c = 'int64';
+       case 'o'
+          c = 'uint8';
+       case 'w'
+          c = 'uint16';
+       case 'u'
+          c = 'uint32';
+       case 'q'
+          c = 'uint64';
        case 'T'
           c = 'char';
+       case 'P'
+          c = 'char';
+       case 'D'
+          c = 'char';
        case 'B'
           c = 'char';
+       case 'b'
+          c = 'uint8';
+       case 'V'
+          c = 'int64';
+       case 'M'
+          c = 'uint8';
        otherwise
           error(['Could not find class for cmm_type: ' type]);
     end
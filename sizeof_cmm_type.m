@@ -6,6 +6,18 @@ function b = sizeof_cmm_type(type)
         b = 4;
     case 'L'
         b = 8;
+    case 'U'
+        b = 8;
+    case 'F'
+        b = 4;
+    case {'c', 'o'}
+        b = 1;
+    case {'s', 'w'}
+        b = 2;
+    case 'u'
+        b = 4;
+    case {'l', 'q'}
+        b = 8;
     case 'T'
         b = 1;
     case 'B'
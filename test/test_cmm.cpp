@@ -95,6 +95,375 @@ int main(int argc, char* argv[])
    cmm.close();
 
    cout << "done reading test_cpp.dat" << endl;
+
+#ifdef CMMFile_THREADS
+   // all entries decoded in parallel
+
+   vector<CMMFile::value> vals;
+   cmm.open_read("test_cpp.dat");
+   cmm.read_all_parallel(vals, 2);
+   cout << vals.size() << " entries, " << vals[1].data<string>()[0] << " == " << s;
+   cout << ", matrix " << vals[3].h.dim[0] << " x " << vals[3].h.dim[1] << endl;
+   cmm.close();
+   {
+      ifstream in("test_cpp.dat", ios::binary);
+      string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+      vector<CMMFile::value> mvals;
+      cmm.open_read_memory(bytes.data(), bytes.size());
+      cmm.read_all_parallel(mvals, 2);
+      cout << "in memory: " << mvals.size() << " == " << vals.size() << ", " << mvals[1].data<string>()[0] << " == " << s;
+      cout << ", " << cmm.fail() << " == 0" << endl;
+      cmm.close();
+   }
+#endif
+
+   // memory mapped reading without copying
+
+   cmm.open_read_mmap("test_cpp.dat");
+   cmm >> ff >> ss;
+
+   CMMFile_SIZETYPE n1, n2;
+   CMMFile_view<int> vin = cmm.read_view<int>(n1);
+   for (int i = 0; i < n1; i++) {
+      cout << v[i] << " == " << vin[i] << endl;
+   }
+
+   CMMFile_view<double> vvin = cmm.read_view<double>(n1, n2);
+   cout << "matrix " << n1 << " x " << n2 << ": " << vvin[n2 + 2] << " == 200" << endl;
+
+   cmm.close();
+
+   cout << "done mapping test_cpp.dat" << endl;
+
+   // posix backend with small buffer
+
+   cmm.set_backend(CMMFile::backend_posix, 64);
+   cmm.open_write("test4_cpp.dat");
+   for (int i = 0; i < 100; i++) {
+      cmm << 0.5 * i;
+   }
+   cmm << vv << s;
+   cmm.close();
+
+   cmm.open_read("test4_cpp.dat");
+   for (int i = 0; i < 100; i++) {
+      cmm >> ff;
+   }
+   cout << ff << " == " << 49.5 << endl;
+   cmm >> vv >> ss;
+   cout << vv[1][2] << " == 200, " << ss << " == " << s << endl;
+   cmm.close();
+   cmm.set_backend(CMMFile::backend_fstream);
+
+   cout << "done reading test4_cpp.dat" << endl;
+
+   // writer thread with two small buffers
+
+   cmm.set_backend(CMMFile::backend_async, 64);
+   cmm.open_write("test4a_cpp.dat");
+   cmm.write_start_sequence();
+   cmm.write_header_sequence<int>();
+   cmm.write_header_sequence<double>(3);
+   cmm.write_end_sequence();
+   vector<double> va(3);
+   for (int i = 0; i < 100; i++) {
+      va[2] = 0.5 * i;
+      cmm.write_data_sequence(i);
+      cmm.write_data_sequence(va);
+   }
+   cmm.close();
+
+   cmm.open_read("test4a_cpp.dat");
+   vector<int> vsi;
+   vector< vector<double> > vsd;
+   cmm.read_sequence(vsi, vsd);
+   cout << vsi.size() << " == 100, " << vsd[99][2] << " == 49.5" << endl;
+   cmm.close();
+
+#ifdef __linux__
+   // write errors of the writer thread set failbit at sync and close
+   cmm.open_write("/dev/full");
+   cmm << va;
+   cout << "full disk: " << cmm.sync() << " == -1, ";
+   cmm.close();
+   cmm.clear();
+   cmm.open_write("/dev/full");
+   cmm << va;
+   cmm.close();
+   cout << cmm.fail() << " == 1" << endl;
+   cmm.clear();
+#endif
+   cmm.set_backend(CMMFile::backend_fstream);
+
+   cout << "done reading test4a_cpp.dat" << endl;
+
+#if __cplusplus >= 201103L
+   // same sequence with columns fixed at compile time
+
+   CMMFile::sequence<int, vector<double> > seq(cmm);
+   int si;
+   vector<double> sd;
+   int nseq = 0;
+   cmm.open_read("test4a_cpp.dat");
+   seq.read_header();
+   while (seq.read(si, sd)) nseq++;
+   cout << "typed sequence: " << nseq << " == 100, " << si << ", " << sd[2] << " == 99, 49.5" << endl;
+   cmm.close();
+
+   cmm.open_write("test4b_cpp.dat");
+   seq.write_header();
+   seq.write_batch(vsi, vsd);
+   cmm.close();
+   cmm.open_read("test4b_cpp.dat");
+   cmm.read_sequence(vsi, vsd);
+   cout << "batch: " << vsi.size() << " == 100, " << vsd[99][2] << " == 49.5" << endl;
+   cmm.close();
+
+   // batches from arrays and single records give the same bytes
+   cmm.open_write("test4c_cpp.dat");
+   seq.write_header();
+   for (size_t k = 0; k < vsi.size(); k++) seq.write(vsi[k], vsd[k]);
+   cmm.close();
+   cmm.open_write("test4d_cpp.dat");
+   seq.write_header();
+   seq.write_batch(vsi.size(), &vsi[0], &vsd[0]);
+   cmm.close();
+   ifstream fb("test4b_cpp.dat", ios::binary), fc("test4c_cpp.dat", ios::binary), fdd("test4d_cpp.dat", ios::binary);
+   string sb((istreambuf_iterator<char>(fb)), istreambuf_iterator<char>());
+   string sc((istreambuf_iterator<char>(fc)), istreambuf_iterator<char>());
+   string sdd((istreambuf_iterator<char>(fdd)), istreambuf_iterator<char>());
+   cout << "batch bytes: " << (sb == sc) << " " << (sdd == sc) << " " << sc.size() << " == 1 1 " << sb.size() << endl;
+
+   CMMFile::sequence<string, bool> seqs(cmm);
+   vector<string> bs;
+   vector<bool> bb;
+   for (int i = 0; i < 10; i++) {
+      bs.push_back(string(i, 'a'));
+      bb.push_back(i % 2 == 0);
+   }
+   cmm.open_write("test4s_cpp.dat");
+   seqs.write_header();
+   seqs.write_batch(bs, bb);
+   cmm.close();
+   cmm.open_write("test4t_cpp.dat");
+   seqs.write_header();
+   for (size_t k = 0; k < bs.size(); k++) seqs.write(bs[k], bb[k]);
+   cmm.close();
+   ifstream fe("test4s_cpp.dat", ios::binary), ff2("test4t_cpp.dat", ios::binary);
+   string se((istreambuf_iterator<char>(fe)), istreambuf_iterator<char>());
+   string sf((istreambuf_iterator<char>(ff2)), istreambuf_iterator<char>());
+   cout << "batch text bytes: " << (se == sf) << " == 1" << endl;
+#endif
+
+   // same sequence column wise
+
+   CMMFile_column<int> ci;
+   CMMFile_column<double> cd;
+   cmm.open_read("test4a_cpp.dat");
+   cmm.read_columns(ci, cd);
+   cout << "columns: " << ci.records() << " == 100, " << cd.values.size() << " == 300, "
+        << cd.values[cd.offset(99) + 2] << " == 49.5" << endl;
+   cmm.close();
+
+#ifdef CMMFile_PMR
+   // sequence records in the arena of the file
+
+   cmm.open_read("test4a_cpp.dat");
+   {
+      std::pmr::vector<int> psi(cmm.arena());
+      std::pmr::vector< std::pmr::vector<double> > psd(cmm.arena());
+      cmm.read_sequence(psi, psd);
+      cout << "pmr: " << psi.size() << " == 100, " << psd[99][2] << " == 49.5" << endl;
+   }
+   cmm.release_arena();
+   cmm.close();
+#endif
+
+   // xor delta coded sequence column
+
+   cmm.open_write("test4x_cpp.dat");
+   cmm.write_start_sequence();
+   cmm.write_header_sequence_xor();
+   cmm.write_end_sequence();
+   for (int i = 0; i < 100; i++) {
+      cmm.write_data_sequence(0.01 * i * i);
+   }
+   cmm.close();
+
+   cmm.open_read("test4x_cpp.dat");
+   cmm.read_header_sequence();
+   double fx = 0;
+   while (cmm.peek() != EOF) cmm.read_data_sequence(fx);
+   cout << fx << " == " << 0.01 * 99 * 99 << endl;
+   cmm.close();
+
+#if __cplusplus >= 201103L
+   // typed sequences do not read coded columns
+   CMMFile::sequence<double> seqx(cmm);
+   cmm.open_read("test4x_cpp.dat");
+   seqx.read_header();
+   cout << "coded column: " << cmm.fail() << " == 1, " << seqx.read(fx) << " == 0" << endl;
+   cmm.close();
+   cmm.clear();
+#endif
+
+   cout << "done reading test4x_cpp.dat" << endl;
+
+   // delta varint coded index lists
+
+   cmm.open_write("test4v_cpp.dat");
+   cmm.write_start_sequence();
+   cmm.write_header_sequence_varint(-1);
+   cmm.write_end_sequence();
+   for (int i = 0; i < 10; i++) {
+      vector<int> ids;
+      for (int j = i; j < 100; j += i + 1) ids.push_back(j);
+      cmm.write_data_sequence(ids);
+   }
+   cmm.close();
+
+   cmm.open_read("test4v_cpp.dat");
+   cmm.read_header_sequence();
+   vector<int> ids;
+   while (cmm.peek() != EOF) cmm.read_data_sequence(ids);
+   cout << ids.size() << " == 10, " << ids[9] << " == 99" << endl;
+   cmm.close();
+
+   vector< vector<int> > evi;
+   cmm.open_write("test4ve_cpp.dat");
+   cmm.write_varint(evi);
+   cmm.close();
+   cmm.open_read("test4ve_cpp.dat");
+   evi.resize(1);
+   cmm >> evi;
+   cout << "empty varints: " << evi.size() << " == 0" << endl;
+   cmm.close();
+
+   CMMFile_column<int> cv;
+   cmm.open_read("test4v_cpp.dat");
+   cmm.read_columns(cv);
+   cout << "varint column: " << cv.records() << " == 10, " << cv.length(0) << " == 100, "
+        << cv.values[cv.offset(9) + cv.length(9) - 1] << " == 99" << endl;
+   cmm.close();
+
+   // column of records without values
+
+   cmm.open_write("test4z_cpp.dat");
+   cmm.write_start_sequence();
+   cmm.write_header_sequence<int>();
+   cmm.write_header_sequence<double>(0);
+   cmm.write_end_sequence();
+   for (int i = 0; i < 5; i++) {
+      cmm.write_data_sequence(i);
+      cmm.write_data_sequence(vector<double>());
+   }
+   cmm.close();
+
+   CMMFile_column<int> cz1;
+   CMMFile_column<double> cz2;
+   cmm.open_read("test4z_cpp.dat");
+   cmm.read_columns(cz1, cz2);
+   cout << "empty column: " << cz1.records() << " " << cz2.records() << " " << cz1.values[4] << " == 5 5 4" << endl;
+   cmm.close();
+
+   cout << "done reading test4v_cpp.dat" << endl;
+
+#ifdef CMMFile_THREADS
+   // prefetching entries in the background
+
+   cmm.open_read("test4_cpp.dat");
+   {
+      CMMFile_prefetch pf(cmm, 4);
+      cout << "prefetching " << pf.size() << " entries, io_uring: " << pf.using_io_uring() << endl;
+      for (int i = 0; i < 100; i++) {
+         pf >> ff;
+      }
+      pf >> vv >> ss;
+      cout << ff << " == " << 49.5 << ", " << vv[1][2] << " == 200, " << ss << " == " << s << endl;
+   }
+   cmm.close();
+
+   cout << "done prefetching test4_cpp.dat" << endl;
+#endif
+
+#if defined(CMMFile_POSIX) && __cplusplus >= 201103L
+   // following a sequence while it is written
+
+   cmm.open_write("test4f_cpp.dat");
+   seq.write_header();
+   seq.write_batch(vsi, vsd);
+   cmm.flush();
+   {
+      CMMFile_follow fl("test4f_cpp.dat");
+      CMMFile_column<int> fi;
+      CMMFile_column<double> fd;
+      fl.wait(1000);
+      fl.poll(fi, fd);
+      seq.write(100, vector<double>(3, 50.0));
+      cmm.flush();
+      fl.wait(1000);
+      fl.poll(fi, fd);
+      cout << "following: " << fi.records() << " == 101, " << fd.values[fd.offset(100) + 2] << " == 50" << endl;
+   }
+   cmm.close();
+
+   // a record flushed by halves is only picked up once it is complete
+   cmm.open_write("test4h_cpp.dat");
+   cmm.write_header<double>(-1, 2);
+   cmm.write_data(1.0);
+   cmm.flush();
+   {
+      CMMFile_follow fl("test4h_cpp.dat");
+      vector<double> fv;
+      fl.wait(1000);
+      size_t first = fl.poll(fv);
+      cmm.write_data(2.0);
+      cmm.flush();
+      fl.wait(1000);
+      size_t second = fl.poll(fv);
+      cout << "torn record: " << first << " == 0, " << second << " == 2, " << fv[1] << " == 2" << endl;
+   }
+   cmm.close();
+#endif
+
+   // index for random access
+
+   cmm.set_index(true);
+   cmm.open_write("test5_cpp.dat");
+   for (int i = 0; i < 10; i++) {
+      cmm << s << i;
+   }
+   cmm << vv;
+   cmm.close();
+   cmm.set_index(false);
+
+   cmm.open_read("test5_cpp.dat");
+   cout << "index: " << cmm.has_index() << ", entries: " << cmm.entry_count() << " == 21" << endl;
+   int ii;
+   cmm.seek_entry(15);
+   cmm >> ii;
+   cout << ii << " == 7" << endl;
+   cmm.seek_last();
+   cmm >> vv;
+   cout << vv[1][2] << " == 200" << endl;
+   CMMFile::entry e20 = cmm.get_entry(20);
+   cout << "index dims: " << e20.h.dim.size() << " " << e20.h.dim[0] << " == 2 " << vv.size() << endl;
+   cmm.close();
+
+   cmm.set_index(true);
+   cmm.open_write_append("test5_cpp.dat");
+   cmm << s;
+   cmm.close();
+   cmm.set_index(false);
+
+   cmm.open_read("test5_cpp.dat");
+   cout << "appended index: " << cmm.has_index() << ", entries: " << cmm.entry_count() << " == 22" << endl;
+   cmm.seek_entry(21);
+   cmm >> ss;
+   cout << ss << " == " << s << endl;
+   cmm.close();
+
+   cout << "done reading test5_cpp.dat" << endl;
  
    //continuous file streams
    
@@ -146,6 +515,371 @@ int main(int argc, char* argv[])
    cmm.close();
    
    cout << "done reading test3_cpp.dat" << endl;
+
+   // length prefixed strings
+
+   cmm.open_write("test3p_cpp.dat");
+   cmm.write_prefixed(vs);
+   cmm << 1.5;
+   cmm.close();
+
+   cmm.open_read("test3p_cpp.dat");
+   cmm.skip();
+   cmm >> ff;
+   cout << ff << " == 1.5" << endl;
+   cmm.seekg(0);
+   vs.clear();
+   cmm >> vs;
+   for (vector<string>::iterator it = vs.begin(); it != vs.end(); it++)
+   {
+      cout << (*it) <<endl;
+   }
+   cmm.close();
+
+   cout << "done reading test3p_cpp.dat" << endl;
+
+   // bools as characters and bit packed
+
+   vector<bool> vb;
+   for (int i = 0; i < 37; i++) vb.push_back(i % 3 == 0);
+   cmm.open_write("test6_cpp.dat");
+   cmm << vb;
+   cmm.write_bits(vb);
+   cmm.close();
+
+   cmm.open_read("test6_cpp.dat");
+   vector<bool> vb1, vb2;
+   cmm >> vb1 >> vb2;
+   cout << "bools: " << (vb1 == vb) << " == 1, bits: " << (vb2 == vb) << " == 1" << endl;
+   cmm.close();
+
+   // -1 stream of bits written in two parts, the last one with a stop bit
+   CMMFile::header hb;
+   hb.type = CMMFile_BITS;
+   hb.dim.push_back(-1);
+   cmm.open_write("test6b_cpp.dat");
+   cmm.write_header(hb);
+   cmm.write_data_bits(vector<bool>(vb.begin(), vb.begin() + 32));
+   cmm.write_data_bits(vector<bool>(vb.begin() + 32, vb.end()), true);
+   cmm.close();
+
+   cmm.open_read("test6b_cpp.dat");
+   vb2.clear();
+   cmm >> vb2;
+   cout << "bit stream: " << vb2.size() << " == 37, " << (vb2 == vb) << " == 1" << endl;
+   cmm.close();
+
+   cout << "done reading test6_cpp.dat" << endl;
+
+   // compressed entries
+
+   vector<double> vz(10000);
+   for (int i = 0; i < 10000; i++) vz[i] = (i % 100) * 0.5;
+   cmm.set_compression(4096, 2);
+   cmm.open_write("test7_cpp.dat");
+   cmm.write_compressed(vz);
+   cmm.write_compressed(vv);
+   cmm << 2.5;
+   cmm.close();
+
+   cmm.open_read("test7_cpp.dat");
+   vector<double> vz2;
+   vector< vector<double> > vvz;
+   cmm >> vz2 >> vvz >> ff;
+   cout << "compressed: " << (vz2 == vz) << " == 1, " << (vvz == vv) << " == 1, " << ff << " == 2.5" << endl;
+   cmm.seekg(0);
+   cmm.read_range(vz2, 5050, 3);
+   cout << vz2[0] << ", " << vz2[2] << " == 25, 26" << endl;
+   cmm.close();
+
+   vvz.clear();
+   cmm.open_write("test7e_cpp.dat");
+   cmm.write_compressed(vvz);
+   cmm.close();
+   cmm.open_read("test7e_cpp.dat");
+   vvz.resize(1);
+   cmm >> vvz;
+   cout << "empty compressed: " << vvz.size() << " == 0" << endl;
+   cmm.close();
+
+   cout << "done reading test7_cpp.dat" << endl;
+
+   // dictionary coded strings
+
+   vector<string> labels;
+   for (int i = 0; i < 1000; i++) labels.push_back(vs[i % vs.size()]);
+   cmm.open_write("test3d_cpp.dat");
+   cmm.write_dictionary(labels);
+   cmm.close();
+
+   cmm.open_read("test3d_cpp.dat");
+   vector<int> codes;
+   CMMFile::string_list dict;
+   cmm.read_dictionary(codes, dict);
+   cout << codes.size() << " codes, " << dict.size() << " == 2 strings" << endl;
+   cmm.seekg(0);
+   vector<string> labels2;
+   cmm >> labels2;
+   cout << (labels2 == labels) << " == 1" << endl;
+   cmm.close();
+
+   cout << "done reading test3d_cpp.dat" << endl;
+
+   // empty tables of strings and a -1 stream of empty rows
+
+   vector< vector<string> > evs;
+   cmm.open_write("test3e_cpp.dat");
+   cmm.write_prefixed(evs);
+   cmm.write_dictionary(evs);
+   cmm.write_header<string>(-1, 0);
+   cmm.close();
+
+   cmm.open_read("test3e_cpp.dat");
+   cout << "empty tables:";
+   for (int i = 0; i < 3; i++) {
+      evs.resize(1);
+      cmm >> evs;
+      cout << " " << evs.size();
+   }
+   cout << " == 0 0 0" << endl;
+   cmm.close();
+
+   // empty tables written with <<
+   vector< vector<double> > evd;
+   vector< vector<bool> > evb;
+   cmm.open_write("test3f_cpp.dat");
+   cmm << evs << evd << evb;
+   cmm.close();
+   evs.resize(1); evd.resize(1); evb.resize(1);
+   cmm.open_read("test3f_cpp.dat");
+   cmm >> evs >> evd >> evb;
+   cout << "empty tables with <<: " << evs.size() << " " << evd.size() << " " << evb.size() << " == 0 0 0" << endl;
+   cmm.close();
+
+   // tiled array and part of it
+
+   vector<CMMFile_SIZETYPE> dim3(3), tile3(3, 4);
+   dim3[0] = 10; dim3[1] = 20; dim3[2] = 30;
+   vector<double> field(6000);
+   for (int i = 0; i < 6000; i++) field[i] = i;
+   cmm.open_write("test8_cpp.dat");
+   cmm.write_tiled(field, dim3, tile3);
+   cmm.close();
+
+   cmm.open_read("test8_cpp.dat");
+   vector<double> field2, slab;
+   vector<CMMFile_SIZETYPE> dim4;
+   cmm.read_tiled(field2, dim4);
+   cout << "tiled: " << (field2 == field) << " == 1, " << dim4.size() << " == 3" << endl;
+   vector<CMMFile_SIZETYPE> start(3, 0), count(3, 1), stride(3, 1);
+   start[0] = 5; count[1] = 20; count[2] = 10; stride[2] = 3;
+   cmm.read_hyperslab(slab, cmm.get_entry(0), start, count, stride);
+   cout << slab.size() << " == 200, " << slab[1] << ", " << slab[10] << " == 3003, 3030" << endl;
+   cmm.close();
+
+   // a truncated tiled file fails instead of returning unread values
+   {
+      ifstream in("test8_cpp.dat", ios::binary);
+      string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+      ofstream out("test8t_cpp.dat", ios::binary);
+      out.write(bytes.data(), bytes.size() / 2);
+   }
+   cmm.open_read("test8t_cpp.dat");
+   cmm.read_tiled(field2, dim4);
+   cout << "truncated tiles: " << cmm.fail() << " == 1" << endl;
+   cmm.close();
+
+   cout << "done reading test8_cpp.dat" << endl;
+
+   // every 10th value and 2 of every 3 rows
+
+   cmm.open_write("test9_cpp.dat");
+   cmm << vz << vv;
+   cmm.write_type(CMMFile_REAL);
+   cmm.write_dim(-1);
+   cmm.write_data(vz);
+   cmm.close();
+
+   cmm.open_read("test9_cpp.dat");
+   vector<double> vz10, vzs;
+   vector< vector<double> > vvk;
+   cmm.read_skip(vz10, 1, 9);
+   cmm.read_skip(vvk, 2, 1);
+   cmm.read_skip(vzs, 1, 9);
+   cout << "decimated: " << vz10.size() << " == 1000, " << vz10[5] << " == 25, " << vvk.size() << " == 3, "
+        << vvk[1][2] << " == 200, " << (vzs == vz10) << " == 1" << endl;
+   cmm.close();
+
+   // runs without gaps are the whole entry
+   cmm.set_backend(CMMFile::backend_posix);
+   cmm.open_read("test9_cpp.dat");
+   vector<double> vz0;
+   cmm.read_skip(vz0, 3, 0);
+   cout << "no gaps: " << (vz0 == vz) << " == 1" << endl;
+   cmm.close();
+   cmm.set_backend(CMMFile::backend_fstream);
+
+   cout << "done reading test9_cpp.dat" << endl;
+
+   // 3d tensor in one aligned block
+
+   CMMFile_tensor<double> tensor(dim3), tensor2;
+   for (size_t i = 0; i < tensor.size(); i++) tensor[i] = 0.5 * i;
+   cmm.open_write("test10_cpp.dat");
+   cmm << tensor;
+   cmm.close();
+
+   cmm.open_read("test10_cpp.dat");
+   cmm >> tensor2;
+   cout << "tensor: " << tensor2.dim() << " == 3, " << tensor2.shape[2] << " == 30, "
+        << (tensor2.values == tensor.values) << " == 1" << endl;
+   cmm.seekg(0);
+   cmm.read_tensor(&field2[0], dim3);
+   cout << field2[10] << " == 5" << endl;
+   cmm.close();
+
+   cout << "done reading test10_cpp.dat" << endl;
+
+   // reading into a buffer in pieces
+
+   double piece[4000];
+   CMMFile_SIZETYPE np, total = 0;
+   cmm.open_read("test9_cpp.dat");
+   cmm.skip(2);
+   cmm.read_header<double>(np);
+   while ((np = cmm.read_data_into(piece, 4000, -1)) > 0) total += np;
+   cout << "pieces: " << total << " == 10000" << endl;
+   cmm.close();
+
+#if __cplusplus >= 201103L
+   // vectors that are not zero filled before reading
+
+   vector<double, CMMFile_default_init_allocator<double> > vdi;
+   vector< vector<double, CMMFile_default_init_allocator<double> > > vvdi;
+   cmm.open_read("test9_cpp.dat");
+   cmm >> vdi >> vvdi;
+   cout << "default init: " << vdi.size() << " == 10000, " << vdi[5050] << " == 25, "
+        << vvdi[1][2] << " == 200" << endl;
+   cmm.close();
+#endif
+
+   // matrix in one aligned block
+
+   CMMFile_matrix<double> mat;
+   cmm.open_read("test_cpp.dat");
+   cmm.skip(3);
+   cmm >> mat;
+   cout << "matrix: " << mat.rows << " x " << mat.cols << " == 4 x 5, " << mat(1, 2) << " == 200" << endl;
+   cmm.close();
+
+   // matrix written, as sequence column and as row pointers
+
+   CMMFile_matrix<double> mat2(3, 2);
+   for (int i = 0; i < 6; i++) mat2.values[i] = i + 0.5;
+   double* rows[3] = { &mat2.values[0], &mat2.values[2], &mat2.values[4] };
+   cmm.open_write("test_mat_cpp.dat");
+   cmm << mat2;
+   cmm.write_header<double>(3, 2);
+   cmm.write_data((const double**) rows, 3, 2);
+   cmm.write_start_sequence();
+   cmm.write_header_sequence<double>(-1, 2);
+   cmm.write_end_sequence();
+   cmm.write_data_sequence(mat2);
+   CMMFile_matrix<double> mat4(1, 2);
+   mat4(0, 1) = 7;
+   cmm.write_data_sequence(mat4);
+   cmm.close();
+
+   cmm.open_read("test_mat_cpp.dat");
+   CMMFile_matrix<double> mat3;
+   cmm >> mat3;
+   cout << "written matrix: " << (mat3.values == mat2.values) << " == 1" << endl;
+   CMMFile::header hm;
+   cmm.read_header(hm);
+   double** prows = 0;
+   cmm.read_data(prows, hm.dim[0], hm.dim[1]);
+   cout << "row pointers: " << prows[0][0] << ", " << prows[0][1] << ", " << prows[2][1] << " == 0.5, 1.5, 5.5" << endl;
+   for (int i = 0; i < 3; i++) delete[] prows[i];
+   delete[] prows;
+   cmm.read_header_sequence();
+   cmm.read_data_sequence(mat3);
+   cout << "matrix column: " << (mat3.values == mat2.values);
+   cmm.read_data_sequence(mat3);
+   cout << " " << mat3.rows << " x " << mat3.cols << " " << mat3(0, 1) << " == 1 1 x 2 7" << endl;
+   cmm.close();
+
+   // fixed width numbers, read back converted
+
+   vector<float> vf(5, 1.5f);
+   vector<unsigned short> vw(3, 60000);
+   cmm.open_write("test11_cpp.dat");
+   cmm << vf << vw;
+   cmm.close();
+   vector<double> vfd, vwd;
+   cmm.open_read("test11_cpp.dat");
+   cmm >> vfd >> vwd;
+   cout << "fixed width: " << vfd.size() << " == 5, " << vfd[4] << " == 1.5, " << vwd[2] << " == 60000" << endl;
+   cmm.close();
+
+   // lossy storage of doubles
+
+   vector<double> vl(1000);
+   for (int i = 0; i < 1000; i++) vl[i] = 0.25 * i;
+   cmm.open_write("test12_cpp.dat");
+   cmm.write_half(vl);
+   cmm.write_bfloat16(vl);
+   cmm.write_quantized(vl, 8);
+   cmm.close();
+   vector<double> vh, vbf, vq;
+   cmm.open_read("test12_cpp.dat");
+   cmm >> vh >> vbf >> vq;
+   cout << "lossy: " << vh[999] << " == 249.75, " << vbf[999] << " == 250, " << vq[999] << " == 249.75" << endl;
+   cmm.close();
+
+   // error bounds over values off the grids, half relative 2^-11, quantized scale / 2
+   vector<double> vr(1000);
+   for (int i = 0; i < 1000; i++) vr[i] = 100.0 / (i + 1) + 0.3 * i - 50;
+   double lo = *min_element(vr.begin(), vr.end()), hi = *max_element(vr.begin(), vr.end());
+   cmm.open_write("test12r_cpp.dat");
+   cmm.write_half(vr);
+   cmm.write_quantized(vr, 8);
+   cmm.close();
+   cmm.open_read("test12r_cpp.dat");
+   cmm >> vh >> vq;
+   cmm.close();
+   double eh = 0, eq = 0;
+   for (int i = 0; i < 1000; i++) {
+      double d = vh[i] - vr[i], a = vr[i] < 0 ? -vr[i] : vr[i];
+      eh = max(eh, (d < 0 ? -d : d) / a);
+      d = vq[i] - vr[i];
+      eq = max(eq, d < 0 ? -d : d);
+   }
+   cout << "lossy bounds: " << (eh <= 1.0 / 2048) << " == 1, " << (eq <= (hi - lo) / 255 / 2 * (1 + 1e-12)) << " == 1" << endl;
+
+   // -1 stream of halfs written in two parts
+   cmm.open_write("test12s_cpp.dat");
+   cmm.write_type(CMMFile_HALF);
+   cmm.write_dim(-1);
+   cmm.write_data_half(&vl[0], 4);
+   cmm.write_data_half(&vl[4], 2);
+   cmm.close();
+   cmm.open_read("test12s_cpp.dat");
+   cmm >> vh;
+   cmm.close();
+   cout << "half stream: " << vh.size() << " == 6, " << vh[5] << " == 1.25" << endl;
+
+   // strings in a single buffer
+
+   CMMFile::string_list sl;
+   cmm.open_read("test3_cpp.dat");
+   cmm >> sl;
+   for (size_t i = 0; i < sl.size(); i++) {
+      cout << sl[i] << " (" << sl.length(i) << ")" << endl;
+   }
+#if __cplusplus >= 201703L
+   cout << "view: " << (sl.size() > 0 && sl.view(0) == std::string_view(sl[0])) << " == 1" << endl;
+#endif
+   cmm.close();
    
 
    // files generated by mathematica CMMFile.m package
@@ -5,9 +5,24 @@ function type = to_cmm_type(c)
       case 'int32' 
          type = 'I';
       case 'int64'
-         type = 'L';
+         % fixed width 'l' and 'q', files with them need readers knowing these types
+         type = 'l';
       case 'long'
          type = 'L';
+      case 'uint64'
+         type = 'q';
+      case 'single'
+         type = 'F';
+      case 'int8'
+         type = 'c';
+      case 'int16'
+         type = 's';
+      case 'uint8'
+         type = 'o';
+      case 'uint16'
+         type = 'w';
+      case 'uint32'
+         type = 'u';
       case 'char'
          type = 'T';
       case 'logical'